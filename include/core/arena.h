@@ -0,0 +1,104 @@
+// include/core/arena.h
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+class ThreadPool;
+
+// Linear (bump) allocator for transient per-frame data.
+// Allocation is a pointer bump; nothing is freed individually, everything is
+// released at once by reset(). Not thread-safe: use one arena per thread.
+class LinearArena {
+public:
+    explicit LinearArena(size_t blockSize = 1 << 20);
+
+    LinearArena(const LinearArena&) = delete;
+    LinearArena& operator=(const LinearArena&) = delete;
+    LinearArena(LinearArena&&) noexcept = default;
+    LinearArena& operator=(LinearArena&&) noexcept = default;
+
+    void* allocate(size_t bytes, size_t alignment = alignof(std::max_align_t));
+
+    template <typename T>
+    T* allocateArray(size_t count) {
+        return static_cast<T*>(allocate(sizeof(T) * count, alignof(T)));
+    }
+
+    // Releases every allocation. If the last frame spilled into several blocks
+    // they are merged into one block big enough for the high-water mark.
+    void reset();
+
+    size_t getUsed() const { return used; }
+    size_t getCapacity() const;
+    size_t getHighWaterMark() const { return highWaterMark; }
+
+private:
+    struct Block {
+        std::unique_ptr<std::byte[]> memory;
+        size_t size = 0;
+    };
+
+    void addBlock(size_t minSize);
+
+    std::vector<Block> blocks;
+    size_t blockSize;
+    size_t currentBlock = 0;
+    size_t offset = 0;
+    size_t used = 0;
+    size_t highWaterMark = 0;
+};
+
+// STL-compatible allocator on top of a LinearArena. deallocate() is a no-op,
+// memory comes back when the owning arena is reset.
+template <typename T>
+class ArenaAllocator {
+public:
+    using value_type = T;
+
+    ArenaAllocator(LinearArena& a) noexcept : arena(&a) {}
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U>& other) noexcept : arena(other.arena) {}
+
+    T* allocate(size_t n) { return arena->allocateArray<T>(n); }
+    void deallocate(T*, size_t) noexcept {}
+
+    template <typename U>
+    bool operator==(const ArenaAllocator<U>& other) const noexcept { return arena == other.arena; }
+    template <typename U>
+    bool operator!=(const ArenaAllocator<U>& other) const noexcept { return arena != other.arena; }
+
+private:
+    template <typename U> friend class ArenaAllocator;
+    LinearArena* arena;
+};
+
+template <typename T>
+using ArenaVector = std::vector<T, ArenaAllocator<T>>;
+
+// One arena per ThreadPool worker, plus one for each other thread that asks
+// (the submitting main thread, loader threads). local() picks the calling
+// thread's arena, so threads never share an arena. reset() must not run while
+// another thread still allocates for the current frame.
+class FrameArenas {
+public:
+    FrameArenas(ThreadPool& tp, size_t blockSize = 1 << 20);
+
+    LinearArena& local();
+    void reset();
+
+    size_t getUsed() const;
+    size_t getHighWaterMark() const; // Sum of the per-thread high-water marks
+
+private:
+    ThreadPool& threadPool;
+    size_t blockSize;
+    std::vector<LinearArena> arenas; // By worker index
+    // Created on first use; unique_ptr keeps them in place as the list grows
+    std::vector<std::pair<std::thread::id, std::unique_ptr<LinearArena>>> threadArenas;
+    mutable std::mutex threadArenasMutex;
+};
@@ -1,5 +1,6 @@
 // include/core/camera.h
 #pragma once
+#include "core/frustum.h"
 #include "math/matrix.h"
 #include "math/vector.h"
 #include "math/transform.h"
@@ -10,6 +11,8 @@ public:
     
     void setPerspective(float fovDegrees, float aspectRatio, float near, float far);
     mat4 getMVP(const mat4& modelMatrix) const;
+    // View frustum in the model space of modelMatrix (world space for the identity)
+    Frustum getFrustum(const mat4& modelMatrix) const { return Frustum(getMVP(modelMatrix)); }
     
     const vec3f& getPosition() const { return m_transform.position; }
     const mat4& getViewMatrix() const { return m_viewMatrix; }
@@ -0,0 +1,30 @@
+// include/core/depth_pyramid.h
+#pragma once
+#include <vector>
+
+class ThreadPool;
+
+// Hierarchical Z buffer: level 0 holds the farthest depth of each 2x2 block of
+// the depth buffer, every further level the farthest of 2x2 texels below it.
+// Anything whose nearest depth is behind the farthest depth of all the texels
+// it covers is hidden. Built from the depth buffer between draws, so it only
+// sees what earlier draws wrote; an empty pyramid hides nothing.
+class DepthPyramid {
+public:
+    // Rebuilds all levels from a width x height depth buffer ([0, 1], 0 = near)
+    void build(const std::vector<float>& depth, int width, int height, ThreadPool* pool = nullptr);
+    void clear() { levels.clear(); }
+    bool empty() const { return levels.empty(); }
+
+    // True if a screen rectangle (pixels, inclusive) whose nearest depth is
+    // nearestDepth lies behind everything already drawn there
+    bool isOccluded(float minX, float minY, float maxX, float maxY, float nearestDepth) const;
+
+private:
+    struct Level {
+        int width = 0;
+        int height = 0;
+        std::vector<float> depth;
+    };
+    std::vector<Level> levels;
+};
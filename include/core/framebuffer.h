@@ -23,6 +23,7 @@ public:
 
     // Getter for depth buffer value
     float getDepth(int x, int y);
+    const std::vector<float>& getDepthBuffer() const { return zBuffer; }
 
     int getWidth() const { return width; }
     int getHeight() const { return height; }
@@ -0,0 +1,29 @@
+// include/core/frustum.h
+#pragma once
+#include "math/matrix.h"
+#include "math/vector.h"
+
+// The six clip planes of a view-projection matrix (Gribb & Hartmann), in the
+// space the matrix transforms from: world space for projection * view, model
+// space for a full MVP. Planes are normalized there, so the plane function
+// gives distances and sphere radii can be compared against it directly.
+// Stored as four plane rows of eight (padded with planes nothing lies
+// outside of) so the tests run four planes per instruction.
+class Frustum {
+public:
+    Frustum() = default;
+    explicit Frustum(const mat4& matrix);
+
+    // Plane i as (a, b, c, d), inside where a*x + b*y + c*z + d >= 0
+    vec4f getPlane(int i) const { return vec4f(a[i], b[i], c[i], d[i]); }
+
+    // Conservative: true only if the volume lies entirely behind one plane
+    bool sphereOutside(const vec3f& center, float radius) const;
+    bool boxOutside(const vec3f& boxMin, const vec3f& boxMax) const;
+
+private:
+    alignas(16) float a[8] = {};
+    alignas(16) float b[8] = {};
+    alignas(16) float c[8] = {};
+    alignas(16) float d[8] = {1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f};
+};
@@ -25,6 +25,14 @@ public:
     std::shared_ptr<Texture> aoTexture;
     std::shared_ptr<Texture> specularTexture;
     std::shared_ptr<Texture> glossTexture;
+
+    // Specular (R), gloss (G) and AO (B) packed into one texture at load time.
+    // Replaces the separate scalar maps it was built from; a flag is set only
+    // if that channel's source loaded.
+    std::shared_ptr<Texture> packedScalarTexture;
+    bool packedSpecular = false;
+    bool packedGloss = false;
+    bool packedAo = false;
     
     std::shared_ptr<Shader> shader;
 
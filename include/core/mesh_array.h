@@ -0,0 +1,64 @@
+// include/core/mesh_array.h
+#pragma once
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+class MappedFile;
+
+// One vertex or index stream of a model: either owned, or a read-only view into
+// a mapped file (mesh cache, glTF buffers) that the array keeps alive. Const
+// access is the same for both. Non-const data() and operator[] copy a mapped
+// stream into owned storage first (copy on write), so writes never reach the
+// read-only mapping; use const access for reads. The copy is not synchronized:
+// do not take non-const access to a mapped stream from several threads.
+template <typename T>
+class MeshArray {
+public:
+    MeshArray() = default;
+    MeshArray(std::vector<T>&& elements) : owned(std::move(elements)) {}
+
+    MeshArray& operator=(std::vector<T>&& elements) {
+        owned = std::move(elements);
+        mapping.reset();
+        view = nullptr;
+        viewSize = 0;
+        return *this;
+    }
+
+    static MeshArray mapped(std::shared_ptr<const MappedFile> file, const T* elements, size_t count) {
+        MeshArray array;
+        array.mapping = std::move(file);
+        array.view = elements;
+        array.viewSize = count;
+        return array;
+    }
+
+    const T* data() const { return mapping ? view : owned.data(); }
+    T* data() {
+        makeOwned();
+        return owned.data();
+    }
+    size_t size() const { return mapping ? viewSize : owned.size(); }
+    bool empty() const { return size() == 0; }
+    bool isMapped() const { return mapping != nullptr; }
+
+    const T& operator[](size_t index) const { return data()[index]; }
+    T& operator[](size_t index) { return data()[index]; }
+
+    const T* begin() const { return data(); }
+    const T* end() const { return data() + size(); }
+
+    void assign(size_t count, const T& value) { *this = std::vector<T>(count, value); }
+    void clear() { *this = std::vector<T>(); }
+
+private:
+    void makeOwned() {
+        if (mapping) *this = std::vector<T>(view, view + viewSize);
+    }
+
+    std::vector<T> owned;
+    std::shared_ptr<const MappedFile> mapping;
+    const T* view = nullptr;
+    size_t viewSize = 0;
+};
@@ -0,0 +1,22 @@
+// include/core/mesh_cache_file.h
+#pragma once
+#include "core/model.h"
+#include <memory>
+#include <string>
+
+// On-disk copy of a loaded model (welded vertex streams, index buffer, tangent
+// frames and bounds), so later runs skip OBJ parsing, welding and tangent
+// calculation. One file per source, named by a hash of its absolute path, and
+// only used while the source's size and modification time match. Loading maps
+// the file read-only and the model's arrays point straight into the mapping.
+// Every set of load options (tangent space, quantization) has its own file.
+class MeshCacheFile {
+public:
+    // nullptr if there is no valid cache file for this source
+    static std::shared_ptr<Model> load(const std::string& cacheDirectory, const std::string& filename, const ModelLoadOptions& options = {});
+    // Writes the model's streams (to a temporary file renamed into place)
+    static bool store(const std::string& cacheDirectory, const std::string& filename, const Model& model,
+                      const ModelLoadOptions& options = {});
+
+    static std::string cachePath(const std::string& cacheDirectory, const std::string& filename, const ModelLoadOptions& options = {});
+};
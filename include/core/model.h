@@ -2,48 +2,116 @@
 #pragma once
 #include <vector>
 #include <string>
+#include <cstdint>
 #include "math/vector.h"
 #include "math/matrix.h"
-#include "core/resource_manager.h"
+#include "core/mesh_array.h"
+#include "core/vertex_quantization.h"
 #include "core/texture/texture.h"
 
+class ThreadPool;
+
 class Model {
 public:
+    // A triangle as read from an OBJ file: separate position, texture coordinate
+    // and normal indices per corner. Only used while loading, weldVertices()
+    // turns faces into the indexed vertex buffer the renderer draws.
     struct Face {
         int vertIndex[3];
-        int uvIndex[3];
-        int normIndex[3];
+        int uvIndex[3] = {-1, -1, -1};   // -1 if the face has no texture coordinates
+        int normIndex[3] = {-1, -1, -1}; // -1 if the face has no normals
 
         Face() = default;
     };
 
+    // A cluster of nearby triangles, drawn and culled as one unit: at most
+    // MaxMeshletVertices vertices and MaxMeshletTriangles triangles, with a
+    // bounding sphere and a cone around its face normals (model space)
+    struct Meshlet {
+        vec3f center;
+        float radius;
+        vec3f coneAxis;          // Mean face normal
+        float coneCutoff;        // Sine of the widest face normal's angle to the axis, 1 if too wide to cull
+        uint32_t vertexOffset;   // First entry in meshletVertices
+        uint32_t triangleOffset; // First entry in meshletTriangles, three local vertex numbers per triangle
+        uint32_t vertexCount;
+        uint32_t triangleCount;
+    };
+    static constexpr int MaxMeshletVertices = 64;
+    static constexpr int MaxMeshletTriangles = 124;
+
     Model() = default;
 
-    void calculateTangents();
+    // Merges the corners of `faces` that share position, texture coordinate and
+    // normal into single vertices: afterwards every stream below holds one entry
+    // per vertex and `indices` three per triangle, and `faces` is cleared.
+    // Corners without a normal get the area weighted normal of their position.
+    void weldVertices();
+    // Accumulate: area weighted sum of the triangles' UV gradients, bitangent
+    // orthogonalized to the tangent. MikkTSpace: the tangent space the common
+    // normal map bakers use (angle weighted, vertices on UV mirror seams split,
+    // bitangent = sign * cross(normal, tangent)), for normal maps baked that way.
+    enum class TangentMode { Accumulate, MikkTSpace };
+    // Runs across the pool if there is one. MikkTSpace may add vertices, so
+    // call it before optimizeMesh / buildMeshlets.
+    void calculateTangents(TangentMode mode = TangentMode::Accumulate, ThreadPool* pool = nullptr);
+    // Axis-aligned box and bounding sphere around the vertices (empty models
+    // get a zero box)
+    void calculateBounds();
+    // Packs the float vertex streams into quantizedVertices (see
+    // vertex_quantization.h) and releases them. Runs last: needs tangents and
+    // bounds, and the float accessors below are invalid afterwards.
+    void quantizeVertices();
+    bool isQuantized() const { return !quantizedVertices.empty(); }
 
     // Accessors for geometry data
-    size_t numVertices() const { return vertices.size(); }
-    size_t numFaces() const { return faces.size(); }
-    size_t numNormals() const { return normals.size(); }
-    size_t numUVs() const { return uvs.size(); }
-    size_t numTangents() const { return tangents.size(); }    
-    size_t numBitangents() const { return bitangents.size(); }
-
-
-    const vec3f& getVertex(int index) const;
-    const vec3f& getNormal(int index) const;
-    const vec2f& getUV(int index) const;
-    const Vector3<float>& getTangent(int index) const;  
-    const Vector3<float>& getBitangent(int index) const;
-    const Face& getFace(int index) const;
-
-    std::vector<vec3f> vertices;
-    std::vector<vec3f> normals;
-    std::vector<vec2f> uvs;
-    std::vector<vec3f> tangents;  
-    std::vector<vec3f> bitangents;
-    std::vector<Face> faces;
-
-    friend class ResourceManager; 
-
-};
\ No newline at end of file
+    size_t numVertices() const { return isQuantized() ? quantizedVertices.size() : vertices.size(); }
+    size_t numFaces() const { return indices.size() / 3; }
+    // Bytes of all streams, owned or mapped
+    size_t getMemoryUsage() const;
+
+    const vec3f& getVertex(uint32_t index) const { return vertices[index]; }
+    const vec3f& getNormal(uint32_t index) const { return normals[index]; }
+    const vec2f& getUV(uint32_t index) const { return uvs[index]; }
+    const vec3f& getTangent(uint32_t index) const { return tangents[index]; }
+    const vec3f& getBitangent(uint32_t index) const { return bitangents[index]; }
+    // The three vertex indices of a triangle
+    const uint32_t* getTriangle(size_t face) const { return indices.data() + face * 3; }
+
+    // Vertex streams (structure of arrays, all numVertices() long once welded).
+    // Owned after parsing, views into the mesh cache file when loaded from it.
+    MeshArray<vec3f> vertices;
+    MeshArray<vec3f> normals;
+    MeshArray<vec2f> uvs;
+    MeshArray<vec3f> tangents;
+    MeshArray<vec3f> bitangents;
+    MeshArray<uint32_t> indices;
+    // Replaces the five streams above once quantized
+    MeshArray<QuantizedVertex> quantizedVertices;
+
+    // Meshlets cover every triangle of `indices` (see buildMeshlets in mesh_optimizer.h)
+    MeshArray<Meshlet> meshlets;
+    MeshArray<uint32_t> meshletVertices;  // Model vertex of each meshlet's local vertex
+    MeshArray<uint8_t> meshletTriangles;  // Local vertex numbers
+
+    // OBJ triangles, until welded
+    MeshArray<Face> faces;
+
+    vec3f boundsMin = vec3f(0.0f, 0.0f, 0.0f);
+    vec3f boundsMax = vec3f(0.0f, 0.0f, 0.0f);
+    float boundsRadius = 0.0f; // Sphere around the vertices, centered on the box
+    vec3f getBoundsCenter() const { return (boundsMin + boundsMax) * 0.5f; }
+
+    friend class ResourceManager;
+
+};
+
+// How a model is prepared after parsing; part of its cache keys
+struct ModelLoadOptions {
+    Model::TangentMode tangentMode = Model::TangentMode::Accumulate;
+    bool quantize = false; // See Model::quantizeVertices
+
+    std::string cacheKey(const std::string& filename) const {
+        return filename + (tangentMode == Model::TangentMode::MikkTSpace ? "|mikktspace" : "") + (quantize ? "|quantized" : "");
+    }
+};
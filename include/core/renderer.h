@@ -7,8 +7,11 @@
 #include "core/light.h"
 #include "core/camera.h"
 #include "core/threadpool.h"
+#include "core/arena.h"
+#include "core/depth_pyramid.h"
 #include "math/matrix.h"
 #include "math/transform.h"
+#include <atomic>
 #include <vector>
 #include <memory>
 
@@ -30,6 +33,14 @@ struct ScreenSpaceGradients {
     // Add gradients for other attributes if needed (e.g., normals)
 };
 
+// Meshlets considered and rejected since the last clear()
+struct MeshletStats {
+    size_t total = 0;
+    size_t frustumCulled = 0;
+    size_t backfaceCulled = 0;
+    size_t occlusionCulled = 0;
+};
+
 struct DrawCommand {
     const Model* model = nullptr;
     const Material* material = nullptr;
@@ -44,6 +55,12 @@ public:
     void setCameraParams(const mat4& view, const mat4& projection, const vec3f& camPos);
     void clear(const vec3f& color);
     void submit(const DrawCommand& command);
+
+    // Per-thread transient memory, valid until the next clear()
+    LinearArena& getFrameArena() { return frameArenas.local(); }
+    size_t getFrameArenaUsed() const { return frameArenas.getUsed(); }
+    size_t getFrameArenaHighWaterMark() const { return frameArenas.getHighWaterMark(); }
+    MeshletStats getMeshletStats() const;
 private:
     Framebuffer& framebuffer;
     std::vector<Light> lights;
@@ -51,6 +68,13 @@ private:
     mat4 projMatrix;
     vec3f currentCameraPosition;
     ThreadPool& threadPool;
+    FrameArenas frameArenas;
+    // Farthest depths of earlier draws, for meshlet occlusion culling. Depth
+    // only gets nearer within a frame, so a pyramid older than the depth buffer
+    // still never hides anything visible; it is rebuilt for large draws only.
+    DepthPyramid depthPyramid;
+    bool depthChanged = false;
+    std::atomic<size_t> meshletCounters[4] = {}; // MeshletStats fields in order
 
     void drawLine(int x0, int y0, int x1, int y1, const vec3f& color);
     void drawTriangle(ScreenVertex v0, ScreenVertex v1, ScreenVertex v2, const Material& material, const ScreenSpaceGradients& gradients);
@@ -74,4 +98,7 @@ private:
     Varyings interpolateVaryings(float t, const Varyings& start, const Varyings& end, float startInvW, float endInvW) const;
     void setupShaderUniforms(Shader& shader, const DrawCommand& command);
     void processFace(const Model& model, const Material& material, Shader& shader, int faceIndex);
+    void submitMeshlets(const Model& model, const Material& material, Shader& shader, const mat4& modelMatrix);
+    void processMeshlet(const Model& model, const Material& material, Shader& shader, const Model::Meshlet& meshlet);
+    void processTriangle(const Varyings& v0, const Varyings& v1, const Varyings& v2, const Material& material);
 };
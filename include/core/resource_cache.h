@@ -0,0 +1,92 @@
+// include/core/resource_cache.h
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Loaded resources by cache key, with their size and the frame they were last
+// used in. A copy-on-write map: readers load the current immutable snapshot and
+// search it without the write mutex, while inserts and erases copy the map and
+// publish the copy (rare next to lookups: once per load or eviction). The
+// snapshot is published through std::atomic<std::shared_ptr>, which is not
+// lock-free in libstdc++ or MSVC, so loading it takes a short internal lock,
+// held only for the reference count and never across a search or a copy.
+template <typename T>
+class ResourceCache {
+public:
+    struct Entry {
+        std::string key;
+        T resource;
+        size_t bytes;
+        mutable std::atomic<uint32_t> lastUsedFrame;
+
+        Entry(const std::string& k, const T& r, size_t b, uint32_t frame) : key(k), resource(r), bytes(b), lastUsedFrame(frame) {}
+    };
+    using Snapshot = std::map<std::string, std::shared_ptr<const Entry>>;
+
+    ResourceCache() : entries(std::make_shared<const Snapshot>()) {}
+
+    // Copies the resource out and marks it used in `frame`
+    bool find(const std::string& key, T& resource, uint32_t frame) const {
+        std::shared_ptr<const Snapshot> snapshot = entries.load(std::memory_order_acquire);
+        auto it = snapshot->find(key);
+        if (it == snapshot->end()) return false;
+        it->second->lastUsedFrame.store(frame, std::memory_order_relaxed);
+        resource = it->second->resource;
+        return true;
+    }
+
+    // Replaces an entry of the same key
+    void insert(const std::string& key, const T& resource, size_t bytes, uint32_t frame) {
+        std::lock_guard<std::mutex> lock(writeMutex);
+        auto next = std::make_shared<Snapshot>(*entries.load(std::memory_order_relaxed));
+        auto& entry = (*next)[key];
+        if (entry) totalBytes.fetch_sub(entry->bytes, std::memory_order_relaxed);
+        entry = std::make_shared<const Entry>(key, resource, bytes, frame);
+        totalBytes.fetch_add(bytes, std::memory_order_relaxed);
+        entries.store(std::move(next), std::memory_order_release);
+    }
+
+    // Removes the listed keys whose entries still have the last-used frame they were
+    // listed with and that `idle` still accepts, both checked under the write mutex
+    // at erase time: an entry a lookup reached since it was listed stays cached. A
+    // lookup already past its snapshot load may still copy an erased resource out;
+    // the copy stays valid, the resource is just no longer cached. Returns the
+    // number of entries removed and adds their bytes to `releasedBytes`
+    template <typename Idle>
+    size_t eraseIdle(const std::vector<std::pair<std::string, uint32_t>>& keys, Idle idle, size_t& releasedBytes) {
+        if (keys.empty()) return 0;
+        std::lock_guard<std::mutex> lock(writeMutex);
+        auto next = std::make_shared<Snapshot>(*entries.load(std::memory_order_relaxed));
+        size_t removed = 0, released = 0;
+        for (const auto& [key, listedFrame] : keys) {
+            auto it = next->find(key);
+            if (it == next->end()) continue;
+            const Entry& entry = *it->second;
+            if (entry.lastUsedFrame.load(std::memory_order_relaxed) != listedFrame || !idle(entry.resource)) continue;
+            released += entry.bytes;
+            removed++;
+            next->erase(it);
+        }
+        if (removed == 0) return 0;
+        totalBytes.fetch_sub(released, std::memory_order_relaxed);
+        entries.store(std::move(next), std::memory_order_release);
+        releasedBytes += released;
+        return removed;
+    }
+
+    // Entries as of now; later inserts and erases do not change it
+    std::shared_ptr<const Snapshot> snapshot() const { return entries.load(std::memory_order_acquire); }
+    size_t getBytes() const { return totalBytes.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<std::shared_ptr<const Snapshot>> entries;
+    std::mutex writeMutex; // Serializes writers only
+    std::atomic<size_t> totalBytes{0};
+};
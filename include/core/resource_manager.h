@@ -3,32 +3,152 @@
 #include <memory>
 #include <string>
 #include <map>
+#include <functional>
+#include <future>
+#include <mutex>
 #include <iostream>
 #include "core/model.h"
+#include "core/resource_cache.h"
 #include "core/shader.h"
 #include "core/texture/texture.h"
+#include "core/texture/virtual_texture.h"
+#include "math/transform.h"
 // Potentially include shader headers if managing them too
 
 class Model;
 class Texture;
 class Shader;
+class Material;
+struct GltfMaterial;
+
+// One drawable primitive of a glTF asset, with its material and node transform
+struct ModelPart {
+    std::shared_ptr<Model> model;
+    std::shared_ptr<Material> material;
+    Transform transform;
+};
 
 class ResourceManager {
 public:
     ResourceManager() { std::cout << "ResourceManager" << std::endl; }
+    ~ResourceManager(); // Waits for the asynchronous loads in flight
     // Use shared_ptr to manage resource lifetime
     std::shared_ptr<Model> loadModel(const std::string& filename);
-    std::shared_ptr<Texture> loadTexture(const std::string& filename);
+    // Every primitive of a glTF 2.0 asset (.gltf or .glb, see readGltf). Materials
+    // become Blinn-Phong approximations whose textures go through loadTexture
+    // (with `textureOptions`, usage set per map).
+    std::vector<ModelPart> loadGltf(const std::string& filename, const TextureLoadOptions& textureOptions = {});
+    std::shared_ptr<Texture> loadTexture(const std::string& filename, const TextureLoadOptions& options = {});
     std::shared_ptr<Shader> loadShader(const std::string& name);
+    // Packs single-channel maps into the R, G, B channels of one texture (empty path = unused
+    // channel; see PackedTexture::hasChannel for the ones that loaded). Cached by its source
+    // maps; the sources are not kept unless already cached.
+    std::shared_ptr<Texture> loadPackedTexture(const std::string (&channelFiles)[3], const TextureLoadOptions& options = {});
+
+    // Asynchronous variants: the load runs on the loader pool and the future gets what
+    // the call above would return. A resource that is already loading is not loaded
+    // twice, its future is shared. Without a loader pool they load before returning.
+    std::shared_future<std::shared_ptr<Model>> loadModelAsync(const std::string& filename);
+    std::shared_future<std::vector<ModelPart>> loadGltfAsync(const std::string& filename, const TextureLoadOptions& textureOptions = {});
+    std::shared_future<std::shared_ptr<Texture>> loadTextureAsync(const std::string& filename, const TextureLoadOptions& options = {});
+    std::shared_future<std::shared_ptr<Texture>> loadPackedTextureAsync(const std::string (&channelFiles)[3], const TextureLoadOptions& options = {});
+
+    // Stand-ins to draw with until an asynchronous load finishes: an empty model, and
+    // 1x1 textures that leave a material as it is (white color, flat normal). Other
+    // usages have none; a missing scalar map already falls back to the material.
+    std::shared_ptr<Model> getPlaceholderModel() const;
+    std::shared_ptr<Texture> getPlaceholderTexture(TextureUsage usage) const;
+
+    // Memory budget of the caches in bytes, 0 for none. update() evicts idle resources
+    // (held by nothing but the caches) least recently used first while the cached
+    // models, textures and shaders exceed it; loading one again reloads it. Resources
+    // still referenced elsewhere, e.g. by scene objects, cannot be evicted.
+    void setMemoryBudget(size_t bytes) { memoryBudget = bytes; }
+    size_t getMemoryBudget() const { return memoryBudget; }
+    // Bytes held by the caches: model streams, texel data (resident tails of virtual
+    // textures, whose pages have their own budget) and shader objects
+    size_t getResidentBytes() const;
+    size_t getEvictedCount() const { return evictedCount; }
+    // Evicts every idle resource, whatever the budget
+    void clearUnused();
+
+    // Pool for load-time work (mip generation); loads run single threaded without one
+    void setWorkerPool(ThreadPool* pool) { workerPool = pool; }
+    // Pool the asynchronous loads run on, one load per worker. Kept apart from the worker
+    // pool, whose waits would otherwise include whole loads. Set before loading.
+    void setLoaderPool(ThreadPool* pool) { loaderPool = pool; }
+    // Pool the asynchronous loads fan their load-time work out to (OBJ chunks, mips, block
+    // compression, tangents). Not the worker pool: frames wait for all of its tasks. Without
+    // one, asynchronous loads do that work on their own thread. Must outlive the loader pool.
+    void setLoadWorkerPool(ThreadPool* pool) { loadWorkerPool = pool; }
+    // Directory of preprocessed textures (see TextureCacheFile), empty disables it
+    void setTextureCacheDirectory(const std::string& directory) { textureCacheDirectory = directory; }
+    // Directory of binary models (see MeshCacheFile), empty disables it
+    void setModelCacheDirectory(const std::string& directory) { modelCacheDirectory = directory; }
+    // Tangent space and vertex format of models loaded from now on (asynchronous loads
+    // keep the options and model cache directory of their call)
+    void setModelLoadOptions(const ModelLoadOptions& options) { modelOptions = options; }
 
-    void clearUnused(); // Optional: for cleanup
+    // Call once per frame between frames: streams virtual texture pages, marks the
+    // resources in use, evicts over the budget and starts the next frame
+    void update();
+    uint32_t getFrame() const { return frame.load(std::memory_order_relaxed); }
+    VirtualTextureCache& getVirtualTextureCache() { return virtualTextures; }
 
 private:
+    // Declared before the caches so it outlives every virtual texture
+    VirtualTextureCache virtualTextures;
+    ThreadPool* workerPool = nullptr;
+    ThreadPool* loaderPool = nullptr;
+    ThreadPool* loadWorkerPool = nullptr;
+    std::string textureCacheDirectory;
+    std::string modelCacheDirectory;
+    ModelLoadOptions modelOptions;
+
     // Caches to avoid reloading
-    std::map<std::string, std::shared_ptr<Model>> modelCache;
-    std::map<std::string, std::shared_ptr<Texture>> textureCache;
-    std::map<std::string, std::shared_ptr<Shader>> shaderCache;
+    ResourceCache<std::shared_ptr<Model>> modelCache;
+    ResourceCache<std::vector<ModelPart>> gltfCache;
+    ResourceCache<std::shared_ptr<Texture>> textureCache;
+    ResourceCache<std::shared_ptr<Shader>> shaderCache;
+    // Asynchronous loads in flight, by cache key
+    std::map<std::string, std::shared_future<std::shared_ptr<Model>>> pendingModels;
+    std::map<std::string, std::shared_future<std::vector<ModelPart>>> pendingGltfs;
+    std::map<std::string, std::shared_future<std::shared_ptr<Texture>>> pendingTextures;
+    // Guards the pending loads; never held while loading
+    std::mutex pendingMutex;
+
+    std::atomic<uint32_t> frame{0};
+    size_t memoryBudget = 0;
+    size_t evictedCount = 0;
+    bool overBudgetReported = false;
+
+    // Evicts idle resources, least recently used first, until the caches hold at most
+    // `targetBytes`; returns the number evicted
+    size_t evictIdle(size_t targetBytes);
+
+    // Pool for the load-time work of the calling thread: the load worker pool for loads
+    // on the loader pool (parallelFor would run inline on the loader's own workers)
+    ThreadPool* loadPool() const;
+    // Cached value, the shared future of the pending load, or a new load on the loader pool
+    template <typename T>
+    std::shared_future<T> loadAsync(const ResourceCache<T>& cache, std::map<std::string, std::shared_future<T>>& pending,
+                                    const std::string& cacheKey, std::function<T()> load);
+    template <typename T>
+    void waitForLoads(const std::map<std::string, std::shared_future<T>>& pending);
 
+    // Decodes (or maps from the texture cache directory) without touching textureCache
+    std::shared_ptr<Texture> readTexture(const std::string& filename, const TextureLoadOptions& options);
+    // A texture that is only an input to another one: the cached copy if there is
+    // one, else read without caching it
+    std::shared_ptr<Texture> loadSourceTexture(const std::string& filename, const TextureLoadOptions& options);
+    // The loads behind loadModel and loadGltf, with the options (and model cache
+    // directory) passed in rather than read from the members
+    std::shared_ptr<Model> loadModel(const std::string& filename, const ModelLoadOptions& options, const std::string& cacheDirectory);
+    std::vector<ModelPart> loadGltf(const std::string& filename, const TextureLoadOptions& textureOptions, const ModelLoadOptions& options);
     // Internal helper to load specific texture types (TGA, DDS)
-    bool loadObjFromFile(const std::string& filename, Model& model);
+    bool loadObjFromFile(const std::string& filename, Model& model, const ModelLoadOptions& options);
+    // Steps after parsing shared by all formats: tangents (unless the file had them),
+    // vertex order (for preordered formats only if clearly unoptimized), meshlets, quantization
+    void prepareModel(Model& model, Model::TangentMode tangentMode, bool quantize, bool preordered);
+    std::shared_ptr<Material> createGltfMaterial(const GltfMaterial& source, const TextureLoadOptions& textureOptions);
 };
\ No newline at end of file
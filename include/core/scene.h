@@ -11,6 +11,7 @@
 #include <vector>
 #include <string>
 #include <memory>
+#include <functional>
 
 class ThreadPool;
 
@@ -18,27 +19,46 @@ struct SceneObject {
     std::shared_ptr<Model> modelPtr;
     std::shared_ptr<Material> materialPtr;
     Transform transform;
+    Transform localTransform; // Placement within its asset (glTF node), applied before transform
     struct Animation {
         enum class Type { None, RotateY } type = Type::None;
         float speed = 0.0f;
     } animation;
 };
 
+// Objects submitted and skipped by Scene::render in the last frame
+struct CullStats {
+    size_t visible = 0;
+    size_t culled = 0;
+    size_t missing = 0; // No model: its load failed
+};
+
 class Scene {
 public:
     Scene(int width, int height, ResourceManager& resManager);
+    // Models and textures load asynchronously (see ResourceManager::setLoaderPool):
+    // objects start with placeholders and glTF assets appear once read
     bool loadFromYAML(const std::string& filename);
+    // Also swaps finished loads in, so call it between frames
     void update(float deltaTime);
+    // Submits the objects whose bounds intersect the camera frustum
     void render(Renderer& renderer);
 
     Camera& getCamera() { return camera; }
     auto& getObjects() { return objects; }
     auto& getLights() { return lights; }
+    size_t getNumPendingLoads() const { return pendingLoads.size(); }
+    CullStats getCullStats() const { return cullStats; }
     
 private:
     ResourceManager& resourceManager; 
     Camera camera;
     std::vector<Light> lights;
     std::vector<SceneObject> objects;
+    // One per asynchronous load; installs the result and returns true once it is ready
+    std::vector<std::function<bool()>> pendingLoads;
+    CullStats cullStats;
+
+    void applyFinishedLoads();
 
 };
\ No newline at end of file
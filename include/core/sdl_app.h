@@ -20,6 +20,8 @@ public:
 private:
     ThreadPool threadPool;
     ResourceManager resourceManager;
+    ThreadPool loadWorkerPool; // Parallel work of those loads (see ResourceManager::setLoadWorkerPool)
+    ThreadPool loaderPool; // Asynchronous asset loads (see ResourceManager::setLoaderPool)
     Framebuffer framebuffer; 
     Scene scene; 
     Renderer renderer;
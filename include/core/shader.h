@@ -54,6 +54,7 @@ public:
 
     std::shared_ptr<Texture> uniform_NormalTexture;
     bool uniform_UseNormalMap = false;
+    bool uniform_NormalMapTwoChannel = false; // Samples are signed unit normals, no remap / normalize needed
 
     std::shared_ptr<Texture> uniform_AoTexture;
     bool uniform_UseAoMap = false;
@@ -64,6 +65,12 @@ public:
     std::shared_ptr<Texture> uniform_GlossTexture;
     bool uniform_UseGlossMap = false;
 
+    // Specular (R), gloss (G), AO (B) in one texture, see Material::packedScalarTexture
+    std::shared_ptr<Texture> uniform_PackedScalarTexture;
+    bool uniform_UsePackedSpecular = false;
+    bool uniform_UsePackedGloss = false;
+    bool uniform_UsePackedAo = false;
+
     // --- Lighting Uniforms ---
     vec3f uniform_CameraPosition;
     std::vector<Light> uniform_Lights;
@@ -0,0 +1,44 @@
+// include/core/texture/block_compression.h
+#pragma once
+#include "core/texture/texel_format.h"
+#include <cstddef>
+#include <vector>
+
+class ThreadPool;
+
+// Byte size of a block compressed level of the given dimensions
+inline size_t blockLevelSize(TexelFormat format, int width, int height) {
+    size_t blocksWide = static_cast<size_t>((width + 3) / 4);
+    size_t blocksHigh = static_cast<size_t>((height + 3) / 4);
+    return blocksWide * blocksHigh * bytesPerBlock(format);
+}
+
+// Decodes one 4x4 block into RGBA8 texels (row-major within the block).
+// BC5 writes its two channels into red and green, blue 0, alpha 255.
+// BC4 replicates its channel into red, green and blue, alpha 255.
+void decodeBlockRGBA8(TexelFormat format, const unsigned char* block, unsigned char out[16][4]);
+
+// Decodes a whole level into RGBA8 texels in block order: 64 bytes per block,
+// blocks row-major. That is the Tiled4x4 layout padded to whole tiles. Rows of
+// blocks are decoded in parallel on the pool if one is given.
+void decodeBlockLevelRGBA8(TexelFormat format, const unsigned char* blocks, int width, int height, unsigned char* out,
+                           ThreadPool* pool = nullptr);
+
+// Block format the fast encoder produces for a usage: BC1 for color, BC4 for
+// scalar and BC5 for two-channel normal maps. False for HDR (no 8-bit format fits).
+inline bool encodedBlockFormat(TextureUsage usage, TexelFormat& outFormat) {
+    switch (usage) {
+        case TextureUsage::Color:  outFormat = TexelFormat::BC1; return true;
+        case TextureUsage::Scalar: outFormat = TexelFormat::BC4; return true;
+        case TextureUsage::Normal: outFormat = TexelFormat::BC5; return true;
+        default: return false;
+    }
+}
+
+// Encodes a row-major float level into BC1, BC4 or BC5 blocks with a fast
+// bounding box encoder (one pass over each block, no endpoint search). Texels
+// are read like the matching uncompressed format would store them: colors for
+// BC1, red for BC4, signed unit normals for BC5. Rows of blocks are encoded in
+// parallel on the pool if one is given.
+std::vector<unsigned char> encodeBlockLevel(TexelFormat format, const std::vector<vec3f>& pixels, int width, int height,
+                                            ThreadPool* pool = nullptr);
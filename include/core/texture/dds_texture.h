@@ -51,24 +51,52 @@ struct DDSHeader {
     uint32_t caps4;
     uint32_t reserved2;
 };
+
+// Follows DDSHeader when the FourCC is "DX10"
+struct DDSHeaderDXT10 {
+    uint32_t dxgiFormat;
+    uint32_t resourceDimension;
+    uint32_t miscFlag;
+    uint32_t arraySize;
+    uint32_t miscFlags2;
+};
 #pragma pack(pop)
 
+// DXGI_FORMAT values of the block formats DX10 files can carry
+#define DXGI_FORMAT_BC1_TYPELESS   70
+#define DXGI_FORMAT_BC1_UNORM      71
+#define DXGI_FORMAT_BC1_UNORM_SRGB 72
+#define DXGI_FORMAT_BC3_TYPELESS   76
+#define DXGI_FORMAT_BC3_UNORM      77
+#define DXGI_FORMAT_BC3_UNORM_SRGB 78
+#define DXGI_FORMAT_BC4_TYPELESS   79
+#define DXGI_FORMAT_BC4_UNORM      80
+#define DXGI_FORMAT_BC5_TYPELESS   82
+#define DXGI_FORMAT_BC5_UNORM      83
+#define DXGI_FORMAT_BC7_TYPELESS   97
+#define DXGI_FORMAT_BC7_UNORM      98
+#define DXGI_FORMAT_BC7_UNORM_SRGB 99
+
+#define DDS_DIMENSION_TEXTURE2D 3
+
 
 class DDSTexture : public Texture {
 public:
     bool load(const std::string& filename) override;
-    vec3f sample(float u, float v, const vec2f& ddx, const vec2f& ddy) const override;
 
     bool isCompressed = false;
-    std::string compressionFormat; // e.g., "DXT1", "DXT5", "ATI2"
+    std::string compressionFormat; // e.g., "DXT1", "DXT5", "ATI2", "BC7"
 
     static bool getCompressionFormat(const std::string& filename, std::string& outFormat, std::string& outError);
 
 private:
 
-    static bool readHeader(std::ifstream& file, DDSHeader& header, std::string& outError);
+    // Also reads the DX10 extension header when present (dx10 is zeroed otherwise)
+    static bool readHeader(std::ifstream& file, DDSHeader& header, DDSHeaderDXT10& dx10, std::string& outError);
+    // Block format and display name of a header, false if unsupported
+    static bool blockFormatOf(const DDSHeader& header, const DDSHeaderDXT10& dx10, TexelFormat& outFormat, std::string& outName);
 
-    bool decompressDXT1(const std::vector<unsigned char>& data, int width, int height);
-    bool decompressDXT5(const std::vector<unsigned char>& data, int width, int height);
-    bool decompressATI2(const std::vector<unsigned char>& data, int width, int height);
+    // Decoded level (RGBA8 texels in block order) into the storage format
+    void storeDecodedLevel(std::vector<unsigned char>&& decoded, TexelFormat blockFormat, TexelFormat storageFormat,
+                           int width, int height, MipLevel& outLevel) const;
 };
\ No newline at end of file
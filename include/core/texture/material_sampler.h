@@ -0,0 +1,42 @@
+// include/core/texture/material_sampler.h
+#pragma once
+#include "core/texture/texture.h"
+
+// Samples several maps of one material at the same UV and derivatives.
+// The LOD is computed once per distinct base resolution and the bilinear
+// footprint (wrap, floor, weights) once per distinct level size, so maps of
+// matching resolution share all the addressing work and only pay for the
+// format-specific fetch and blend. Construct one per fragment.
+class MaterialSampler {
+public:
+    MaterialSampler(float u, float v, const vec2f& ddx, const vec2f& ddy)
+        : u(u), v(v), ddx(ddx), ddy(ddy) {}
+
+    // Same result as texture.sample(u, v, ddx, ddy)
+    vec3f sample(const Texture& texture);
+
+private:
+    struct LodEntry {
+        int width, height; // Base level size
+        float lod;
+    };
+
+    struct FootprintEntry {
+        int width, height; // Level size
+        Texture::TexelFootprint footprint;
+    };
+
+    float lodFor(int width, int height);
+    const Texture::TexelFootprint& footprintFor(const Texture::MipLevel& level);
+
+    float u, v;
+    vec2f ddx, ddy;
+
+    // A material binds at most a handful of resolutions; entries past the end are recomputed
+    static constexpr int MaxEntries = 8;
+    LodEntry lods[MaxEntries];
+    int numLods = 0;
+    FootprintEntry footprints[MaxEntries];
+    int numFootprints = 0;
+    Texture::TexelFootprint scratch;
+};
@@ -0,0 +1,42 @@
+// include/core/texture/mip_generator.h
+#pragma once
+#include "math/vector.h"
+#include <cstdint>
+#include <vector>
+
+class ThreadPool;
+
+// Downsampling filter for generated mip levels
+enum class MipFilter : uint8_t {
+    Box,     // Area average (exact 2x2 average for even sizes)
+    Kaiser,  // Kaiser windowed sinc, sharper than box with little ringing
+    Lanczos  // Lanczos-3, sharpest, may ring on hard edges
+};
+
+inline const char* mipFilterName(MipFilter filter) {
+    switch (filter) {
+        case MipFilter::Box:     return "box";
+        case MipFilter::Kaiser:  return "kaiser";
+        case MipFilter::Lanczos: return "lanczos";
+    }
+    return "unknown";
+}
+
+// Float RGB image of one mip level, row-major
+struct MipImage {
+    int width = 0;
+    int height = 0;
+    std::vector<vec3f> pixels;
+};
+
+struct MipGenerationSettings {
+    MipFilter filter = MipFilter::Box;
+    bool gammaCorrect = false; // Average sRGB colors in linear space
+    bool renormalize = false;  // Pixels are unit normals, renormalize every level
+};
+
+// Appends levels down to 1x1 to chain, which holds the base level. Each level is
+// filtered from the previous one in two separable passes; odd sizes use a
+// fractional footprint so no texel is dropped. Rows run in parallel on the
+// pool if one is given. Texels wrap at the edges like the sampler.
+void generateMipChain(std::vector<MipImage>& chain, const MipGenerationSettings& settings, ThreadPool* pool = nullptr);
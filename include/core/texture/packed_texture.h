@@ -0,0 +1,27 @@
+// include/core/texture/packed_texture.h
+#pragma once
+#include "core/texture/texture.h"
+#include <memory>
+
+// Several single-channel maps packed into the channels of one texture, so a
+// material reads them with one fetch. Stored in the narrowest format that
+// holds the last filled channel: R8, RG8Unorm (as small as two R8 maps), or
+// RGBA8 for three (a byte per texel more than three R8 maps). Built by
+// ResourceManager.
+class PackedTexture : public Texture {
+public:
+    static constexpr int MaxChannels = 3; // R, G, B
+
+    // channels[i] (may be null or empty, e.g. if it failed to load) supplies
+    // the red channel of its samples to channel i. Sources of different sizes
+    // are resampled to the largest one.
+    static std::shared_ptr<PackedTexture> create(const Texture* const channels[MaxChannels], TexelLayout layout);
+
+    // Whether channel i came from a source; the others read 0
+    bool hasChannel(int channel) const { return (channelMask >> channel) & 1u; }
+
+private:
+    PackedTexture() = default;
+    uint32_t channelMask = 0;
+    bool load(const std::string&) override { return false; } // Built by create()
+};
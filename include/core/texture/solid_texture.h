@@ -0,0 +1,16 @@
+// include/core/texture/solid_texture.h
+#pragma once
+#include "core/texture/texture.h"
+#include <memory>
+
+// A 1x1 texture of one value, stored in the format of its usage. ResourceManager
+// hands these out as placeholders while the real textures load.
+class SolidTexture : public Texture {
+public:
+    // `value` is a color, or a unit normal for TextureUsage::Normal
+    static std::shared_ptr<SolidTexture> create(const vec3f& value, TextureUsage usage);
+
+private:
+    SolidTexture() = default;
+    bool load(const std::string&) override { return false; } // Built by create()
+};
@@ -0,0 +1,247 @@
+// include/core/texture/texel_format.h
+#pragma once
+#include "math/vector.h"
+#include <cstdint>
+#include <cstring>
+#include <cmath>
+#include <algorithm>
+
+#ifndef NaiveMethod
+#include <immintrin.h>
+// #define NaiveMethod
+#endif
+
+// Storage format of a mip level
+enum class TexelFormat : uint8_t {
+    RGBA8,   // 4 bytes, unorm
+    RG8,     // 2 bytes, normal x/y biased to unorm; sampled as a signed unit normal (see decodeNormalXY)
+    R8,      // 1 byte, unorm; sampled as (r, r, r)
+    RGBA16F, // 8 bytes, IEEE half floats
+    // Block compressed (4x4 texel blocks), decoded on fetch
+    BC1,     // 8 bytes per block, RGB (DXT1)
+    BC3,     // 16 bytes per block, RGBA (DXT5)
+    BC5,     // 16 bytes per block, two channels like RG8 (ATI2)
+    BC4,     // 8 bytes per block, one channel like R8 (ATI1)
+    BC7,     // 16 bytes per block, high quality RGBA
+    RG8Unorm // 2 bytes, two unorm channels (packed scalar maps); sampled as (r, g, 0)
+};
+
+// Texel order of an uncompressed mip level in memory
+enum class TexelLayout : uint8_t {
+    Linear,   // Row-major
+    Tiled4x4  // Row-major 4x4 tiles, row-major texels inside a tile; a bilinear
+              // footprint touches 1-4 tiles whatever the UV direction
+};
+
+// What a texture is used for; loaders pick the storage format from it
+enum class TextureUsage : uint8_t {
+    Color,   // diffuse / albedo
+    Normal,  // tangent-space normal map, stored two-channel and sampled as a signed normal
+    Scalar,  // single channel data: specular, gloss, AO
+    HDR      // values outside [0, 1]
+};
+
+// Storage format a loader picks for decoded (uncompressed) data of a given usage
+inline TexelFormat defaultFormatForUsage(TextureUsage usage) {
+    switch (usage) {
+        case TextureUsage::Scalar: return TexelFormat::R8;
+        case TextureUsage::HDR:    return TexelFormat::RGBA16F;
+        case TextureUsage::Normal: return TexelFormat::RG8;
+        default:                   return TexelFormat::RGBA8;
+    }
+}
+
+// Formats that hold only x and y of a unit normal. Sampling them returns the
+// signed normal (z reconstructed) instead of a color to be remapped by * 2 - 1.
+inline bool isTwoChannelNormal(TexelFormat format) {
+    return format == TexelFormat::RG8 || format == TexelFormat::BC5;
+}
+
+inline bool isBlockCompressed(TexelFormat format) {
+    return format == TexelFormat::BC1 || format == TexelFormat::BC3 || format == TexelFormat::BC5 ||
+           format == TexelFormat::BC4 || format == TexelFormat::BC7;
+}
+
+// Bytes per texel of uncompressed formats, 0 for block compressed ones
+inline int bytesPerTexel(TexelFormat format) {
+    switch (format) {
+        case TexelFormat::RGBA8:   return 4;
+        case TexelFormat::RG8:     return 2;
+        case TexelFormat::RG8Unorm: return 2;
+        case TexelFormat::R8:      return 1;
+        case TexelFormat::RGBA16F: return 8;
+        default:                   return 0;
+    }
+}
+
+// Bytes per 4x4 block of block compressed formats, 0 for uncompressed ones
+inline int bytesPerBlock(TexelFormat format) {
+    switch (format) {
+        case TexelFormat::BC1: return 8;
+        case TexelFormat::BC3: return 16;
+        case TexelFormat::BC5: return 16;
+        case TexelFormat::BC4: return 8;
+        case TexelFormat::BC7: return 16;
+        default:               return 0;
+    }
+}
+
+inline const char* texelFormatName(TexelFormat format) {
+    switch (format) {
+        case TexelFormat::RGBA8:   return "RGBA8";
+        case TexelFormat::RG8:     return "RG8";
+        case TexelFormat::R8:      return "R8";
+        case TexelFormat::RGBA16F: return "RGBA16F";
+        case TexelFormat::BC1:     return "BC1";
+        case TexelFormat::BC3:     return "BC3";
+        case TexelFormat::BC5:     return "BC5";
+        case TexelFormat::BC4:     return "BC4";
+        case TexelFormat::BC7:     return "BC7";
+        case TexelFormat::RG8Unorm: return "RG8Unorm";
+    }
+    return "Unknown";
+}
+
+inline const char* texelLayoutName(TexelLayout layout) {
+    switch (layout) {
+        case TexelLayout::Linear:   return "linear";
+        case TexelLayout::Tiled4x4: return "tiled";
+    }
+    return "unknown";
+}
+
+inline const char* textureUsageName(TextureUsage usage) {
+    switch (usage) {
+        case TextureUsage::Color:  return "color";
+        case TextureUsage::Normal: return "normal";
+        case TextureUsage::Scalar: return "scalar";
+        case TextureUsage::HDR:    return "hdr";
+    }
+    return "unknown";
+}
+
+// --- Half float conversion ---
+
+inline uint16_t floatToHalf(float value) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    uint32_t sign = (bits >> 16) & 0x8000u;
+    int32_t exponent = static_cast<int32_t>((bits >> 23) & 0xFF) - 127 + 15;
+    uint32_t mantissa = bits & 0x7FFFFFu;
+
+    if (exponent <= 0) { // Subnormal or zero
+        if (exponent < -10) return static_cast<uint16_t>(sign);
+        mantissa |= 0x800000u;
+        uint32_t shift = static_cast<uint32_t>(14 - exponent);
+        uint32_t half = mantissa >> shift;
+        if ((mantissa >> (shift - 1)) & 1u) half++; // Round half up
+        return static_cast<uint16_t>(sign | half);
+    }
+    if (exponent >= 31) { // Overflow, Inf or NaN
+        uint32_t nan = (((bits >> 23) & 0xFF) == 0xFF && mantissa) ? 0x200u : 0u;
+        return static_cast<uint16_t>(sign | 0x7C00u | nan);
+    }
+    uint32_t half = sign | (static_cast<uint32_t>(exponent) << 10) | (mantissa >> 13);
+    if (mantissa & 0x1000u) half++; // Round, may carry into the exponent which is fine
+    return static_cast<uint16_t>(half);
+}
+
+inline float halfToFloat(uint16_t half) {
+    uint32_t sign = static_cast<uint32_t>(half & 0x8000u) << 16;
+    uint32_t exponent = (half >> 10) & 0x1F;
+    uint32_t mantissa = half & 0x3FFu;
+    uint32_t bits;
+    if (exponent == 0) {
+        if (mantissa == 0) {
+            bits = sign;
+        } else { // Subnormal: renormalize
+            exponent = 127 - 15 + 1;
+            while (!(mantissa & 0x400u)) { mantissa <<= 1; exponent--; }
+            mantissa &= 0x3FFu;
+            bits = sign | (exponent << 23) | (mantissa << 13);
+        }
+    } else if (exponent == 31) {
+        bits = sign | 0x7F800000u | (mantissa << 13);
+    } else {
+        bits = sign | ((exponent + 127 - 15) << 23) | (mantissa << 13);
+    }
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+// --- Encode / decode of single texels (load-time and slow paths) ---
+
+inline unsigned char floatToUnorm8(float value) {
+    return static_cast<unsigned char>(std::clamp(value, 0.0f, 1.0f) * 255.0f + 0.5f);
+}
+
+inline void encodeTexel(TexelFormat format, const vec3f& color, unsigned char* dst) {
+    switch (format) {
+        case TexelFormat::RGBA8:
+            dst[0] = floatToUnorm8(color.x);
+            dst[1] = floatToUnorm8(color.y);
+            dst[2] = floatToUnorm8(color.z);
+            dst[3] = 255;
+            break;
+        case TexelFormat::RG8: // Signed normal in, biased x and y out
+            dst[0] = floatToUnorm8(color.x * 0.5f + 0.5f);
+            dst[1] = floatToUnorm8(color.y * 0.5f + 0.5f);
+            break;
+        case TexelFormat::RG8Unorm:
+            dst[0] = floatToUnorm8(color.x);
+            dst[1] = floatToUnorm8(color.y);
+            break;
+        case TexelFormat::R8:
+            dst[0] = floatToUnorm8(color.x);
+            break;
+        case TexelFormat::RGBA16F: {
+            uint16_t h[4] = { floatToHalf(color.x), floatToHalf(color.y), floatToHalf(color.z), 0x3C00u };
+            std::memcpy(dst, h, sizeof(h));
+            break;
+        }
+        default: // Block compressed formats are produced by an encoder, not per texel
+            break;
+    }
+}
+
+inline float reconstructZ(float x, float y) {
+    return std::sqrt(std::max(0.0f, 1.0f - x * x - y * y));
+}
+
+// Biased [0, 1] x/y of a two-channel normal format to the signed unit normal
+inline vec3f decodeNormalXY(float r, float g) {
+    float x = r * 2.0f - 1.0f, y = g * 2.0f - 1.0f;
+    return vec3f(x, y, reconstructZ(x, y));
+}
+
+// Normal map color ([0, 1] per channel) to a unit normal, +Z if degenerate
+inline vec3f colorToNormal(const vec3f& color) {
+    vec3f n = color * 2.0f - vec3f(1.0f, 1.0f, 1.0f);
+    float lengthSq = n.lengthSq();
+    return lengthSq > 1e-12f ? n * (1.0f / std::sqrt(lengthSq)) : vec3f(0.0f, 0.0f, 1.0f);
+}
+
+inline vec3f decodeTexel(TexelFormat format, const unsigned char* src) {
+    constexpr float inv255 = 1.0f / 255.0f;
+    switch (format) {
+        case TexelFormat::RGBA8:
+            return vec3f(src[0] * inv255, src[1] * inv255, src[2] * inv255);
+        case TexelFormat::RG8:
+            return decodeNormalXY(src[0] * inv255, src[1] * inv255);
+        case TexelFormat::RG8Unorm:
+            return vec3f(src[0] * inv255, src[1] * inv255, 0.0f);
+        case TexelFormat::R8: {
+            float r = src[0] * inv255;
+            return vec3f(r, r, r);
+        }
+        case TexelFormat::RGBA16F: {
+            uint16_t h[4];
+            std::memcpy(h, src, sizeof(h));
+            return vec3f(halfToFloat(h[0]), halfToFloat(h[1]), halfToFloat(h[2]));
+        }
+        default:
+            break;
+    }
+    return vec3f(1.0f, 0.0f, 1.0f);
+}
@@ -0,0 +1,47 @@
+// include/core/texture/texel_storage.h
+#pragma once
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+class MappedFile;
+
+// Texel bytes of a mip level: either owned, or a read-only view into a mapped
+// file (texture cache) that the storage keeps alive. Read access is the same
+// for both; writing through data() is only valid for owned storage.
+class TexelStorage {
+public:
+    TexelStorage() = default;
+    TexelStorage(std::vector<unsigned char>&& bytes) : owned(std::move(bytes)) {}
+
+    TexelStorage& operator=(std::vector<unsigned char>&& bytes) {
+        owned = std::move(bytes);
+        mapping.reset();
+        view = nullptr;
+        viewSize = 0;
+        return *this;
+    }
+
+    static TexelStorage mapped(std::shared_ptr<const MappedFile> file, const unsigned char* bytes, size_t size) {
+        TexelStorage storage;
+        storage.mapping = std::move(file);
+        storage.view = bytes;
+        storage.viewSize = size;
+        return storage;
+    }
+
+    const unsigned char* data() const { return mapping ? view : owned.data(); }
+    unsigned char* data() { return owned.data(); } // Owned storage only
+    size_t size() const { return mapping ? viewSize : owned.size(); }
+    bool empty() const { return size() == 0; }
+    bool isMapped() const { return mapping != nullptr; }
+
+    void assign(size_t count, unsigned char value) { *this = std::vector<unsigned char>(count, value); }
+    void clear() { *this = std::vector<unsigned char>(); }
+
+private:
+    std::vector<unsigned char> owned;
+    std::shared_ptr<const MappedFile> mapping;
+    const unsigned char* view = nullptr;
+    size_t viewSize = 0;
+};
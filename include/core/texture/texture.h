@@ -1,20 +1,80 @@
 // include/core/texture/texture.h
 #pragma once
 #include "math/vector.h"
+#include "core/texture/texel_format.h"
+#include "core/texture/mip_generator.h"
+#include "core/texture/texel_storage.h"
 #include <vector>
 #include <string>
 
+// Options that influence how a texture file is turned into mip levels.
+// Part of the ResourceManager cache key.
+struct TextureLoadOptions {
+    TextureUsage usage = TextureUsage::Color;
+    // Keep block compressed sources (DDS BC1/BC3/BC4/BC5/BC7) compressed in memory and
+    // decode 4x4 blocks on fetch instead of expanding them at load time
+    bool keepCompressed = false;
+    // Encode uncompressed sources (TGA) into BC1 / BC4 / BC5 blocks after load
+    // (see encodeBlockLevel): 4-8x less memory for some quality; HDR stays as is
+    bool compressOnLoad = false;
+    // Texel order of uncompressed levels (BC levels are always stored as blocks).
+    // Tiled pays off for large textures sampled along rotated or vertical spans.
+    TexelLayout layout = TexelLayout::Linear;
+
+    // Stream the large mip levels as pages under the ResourceManager's page budget
+    // (see VirtualTexture); implies uncompressed storage
+    bool virtualTexture = false;
+
+    // Filter for mip levels generated at load time (files with stored mips keep them)
+    MipFilter mipFilter = MipFilter::Box;
+    // Average color maps in linear space instead of on sRGB values
+    bool gammaCorrectMips = false;
+
+    std::string cacheKey(const std::string& filename) const {
+        return filename + "|" + textureUsageName(usage) + (keepCompressed ? "|bc" : "") + (compressOnLoad ? "|enc" : "") + "|" + texelLayoutName(layout) +
+               (virtualTexture ? "|vt" : "") + "|" + mipFilterName(mipFilter) + (gammaCorrectMips ? "|srgb" : "");
+    }
+};
+
 class Texture {
 public:
     struct MipLevel {
         int width = 0;
         int height = 0;
-        std::vector<vec3f> pixels;
+        TexelFormat format = TexelFormat::RGBA8;
+        TexelLayout layout = TexelLayout::Linear;
+        TexelStorage data;               // Texels in `layout` order (tiled levels are padded to whole tiles); 4x4 blocks for BC formats
+        uint32_t blockCacheId = 0;       // Tags decoded blocks of BC levels in the per-thread block cache
+
+        // Uncompressed formats only
+        // Texel index is separable in both layouts: rowOffset(y) + columnOffset(x),
+        // so a bilinear footprint needs two of each instead of four full addresses
+        size_t rowOffset(int y) const {
+            if (layout == TexelLayout::Tiled4x4) {
+                return static_cast<size_t>(y >> 2) * (((width + 3) >> 2) << 4) + ((y & 3) << 2);
+            }
+            return static_cast<size_t>(y) * width;
+        }
+        size_t columnOffset(int x) const {
+            return layout == TexelLayout::Tiled4x4 ? static_cast<size_t>(((x >> 2) << 4) | (x & 3)) : static_cast<size_t>(x);
+        }
+        size_t texelIndex(int x, int y) const { return rowOffset(y) + columnOffset(x); }
+        const unsigned char* texel(int x, int y) const {
+            return data.data() + texelIndex(x, y) * bytesPerTexel(format);
+        }
+        vec3f fetch(int x, int y) const; // Any format
+    };
+
+    // Integer texel coordinates and weights of a 2x2 bilinear footprint (already wrapped)
+    struct TexelFootprint {
+        int x0, y0, x1, y1;
+        float u_frac, v_frac;
     };
 
     virtual ~Texture() = default;
 
-    virtual vec3f sample(float u, float v, const vec2f& ddx, const vec2f& ddy) const = 0;
+    // Trilinear sample with the LOD from the UV derivatives
+    virtual vec3f sample(float u, float v, const vec2f& ddx, const vec2f& ddy) const;
 
     bool empty() const {
         return mipLevels.empty() || mipLevels[0].width == 0 || mipLevels[0].height == 0;
@@ -24,11 +84,32 @@ public:
     int getHeight() const { return mipLevels.empty() ? 0 : mipLevels[0].height; }
     size_t getNumLevels() const { return mipLevels.size(); }
     const MipLevel& getLevel(size_t level) const { return mipLevels[level]; }
+    TexelFormat getFormat() const { return mipLevels.empty() ? TexelFormat::RGBA8 : mipLevels[0].format; }
+    const TextureLoadOptions& getOptions() const { return options; }
+    size_t getMemoryUsage() const; // Bytes of texel data over all mip levels
 
 protected:
     Texture() = default;
     virtual bool load(const std::string& filename) = 0;
     static vec3f sampleBilinear(const MipLevel& level, float u, float v);
+    // Same filter at a texel-space position (texel centers at integers), tx in [-1, width)
+    static vec3f sampleBilinearTexel(const MipLevel& level, float tx, float ty);
+    float computeLod(const vec2f& ddx, const vec2f& ddy) const; // >= 0, relative to level 0
+    static float lodForSize(const vec2f& ddx, const vec2f& ddy, int width, int height);
+    // Split bilinear sampling: footprint (wrap + floor) and the format-specific blend
+    static TexelFootprint computeFootprint(const MipLevel& level, float u, float v);
+    static vec3f blendFootprint(const MipLevel& level, const TexelFootprint& footprint);
+    // Quantizes a row-major float RGB image into a mip level of the given format and layout
+    static void encodeLevel(const std::vector<vec3f>& pixels, int width, int height, TexelFormat format, MipLevel& outLevel,
+                            TexelLayout layout = TexelLayout::Linear);
+    // Takes ownership of raw 4x4 block data as a mip level of a BC format
+    static void storeBlockLevel(std::vector<unsigned char>&& blocks, int width, int height, TexelFormat format, MipLevel& outLevel);
+    static uint32_t newBlockCacheId(); // For BC levels whose data was set up directly
+
+    TextureLoadOptions options;
     std::vector<MipLevel> mipLevels;
-    friend class ResourceManager; 
-};
\ No newline at end of file
+    ThreadPool* workers = nullptr; // Optional, for load-time work such as mip generation
+    friend class ResourceManager;
+    friend class MaterialSampler;
+    friend class TextureCacheFile;
+};
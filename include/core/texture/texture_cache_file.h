@@ -0,0 +1,21 @@
+// include/core/texture/texture_cache_file.h
+#pragma once
+#include "core/texture/texture.h"
+#include <memory>
+#include <string>
+
+// On-disk copy of a loaded texture's final mip chain (storage format, layout,
+// every level), so later runs skip decoding and mip generation. One file per
+// source and set of load options, named by a hash of both, and only used while
+// the source's size and modification time match. Loading maps the file
+// read-only and the levels point straight into the mapping, so the OS page
+// cache shares it between processes.
+class TextureCacheFile {
+public:
+    // nullptr if there is no valid cache file for this source and options
+    static std::shared_ptr<Texture> load(const std::string& cacheDirectory, const std::string& filename, const TextureLoadOptions& options);
+    // Writes the texture's levels (to a temporary file renamed into place)
+    static bool store(const std::string& cacheDirectory, const std::string& filename, const TextureLoadOptions& options, const Texture& texture);
+
+    static std::string cachePath(const std::string& cacheDirectory, const std::string& filename, const TextureLoadOptions& options);
+};
@@ -5,5 +5,4 @@
 class TGATexture : public Texture {
 public:
     bool load(const std::string& filename) override;
-    vec3f sample(float u, float v, const vec2f& ddx, const vec2f& ddy) const override;
 };
\ No newline at end of file
@@ -0,0 +1,135 @@
+// include/core/texture/virtual_texture.h
+#pragma once
+#include "core/texture/texture.h"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+class VirtualTextureCache;
+
+// Texture whose large mip levels are split into fixed-size pages kept in a
+// page file and streamed in on demand. Levels that fit into a single page
+// (the mip tail) stay resident, so a missing page can always fall back to a
+// coarser resident level.
+class VirtualTexture : public Texture {
+public:
+    static constexpr int PageSize = 128;            // Texels per page side
+    static constexpr int PageStride = PageSize + 2; // Plus a 1 texel border so bilinear never leaves the page
+
+    ~VirtualTexture() override;
+
+    // Writes the paged levels of a loaded (uncompressed) texture to pageFile and
+    // keeps only the mip tail in memory. Returns nullptr on failure.
+    static std::shared_ptr<VirtualTexture> create(const Texture& source, const std::string& pageFile, VirtualTextureCache& cache);
+
+    vec3f sample(float u, float v, const vec2f& ddx, const vec2f& ddy) const override;
+
+    size_t getNumPages() const { return pageCount; }
+    size_t getNumPagedLevels() const { return pagedLevels.size(); }
+
+private:
+    struct Page {
+        MipLevel texels;                          // PageStride^2 texels, empty while not resident
+        std::atomic<uint32_t> lastUsedFrame{0};   // Stamped by the sampler while resident (LRU)
+        std::atomic<uint32_t> requestedFrame{0};  // Feedback: stamped by the sampler while missing
+        bool pending = false;                     // Queued on the loader thread
+    };
+
+    struct PagedLevel {
+        int pagesWide = 0;
+        int pagesHigh = 0;
+        size_t firstPage = 0; // Index into pages
+    };
+
+    VirtualTexture(VirtualTextureCache& cache) : cache(cache) {}
+    bool load(const std::string&) override { return false; } // Built by create()
+
+    // Bilinear sample of one level, falling back to coarser levels when the page is missing
+    vec3f sampleLevel(int level, float u, float v) const;
+
+    VirtualTextureCache& cache;
+    std::string pageFile;
+    size_t pageBytes = 0;
+    std::vector<PagedLevel> pagedLevels;   // mipLevels[i] for i < pagedLevels.size() only carry dimensions
+    std::unique_ptr<Page[]> pages;
+    size_t pageCount = 0;
+
+    friend class VirtualTextureCache;
+};
+
+// Physical page cache shared by all virtual textures: a memory budget, LRU
+// eviction by last used frame, and a dedicated loader thread reading pages
+// from the page files. Pages are only installed and evicted in update(), which
+// must run on the main thread between frames (no sampling in flight).
+class VirtualTextureCache {
+public:
+    explicit VirtualTextureCache(size_t budgetBytes = 64u << 20);
+    ~VirtualTextureCache();
+
+    VirtualTextureCache(const VirtualTextureCache&) = delete;
+    VirtualTextureCache& operator=(const VirtualTextureCache&) = delete;
+
+    // Thread safe; the texture takes part from the next update() on
+    void registerTexture(const std::shared_ptr<VirtualTexture>& texture);
+
+    // Installs finished loads, evicts over budget, queues the pages requested
+    // during the last frame, then advances the frame counter.
+    void update();
+
+    void setBudget(size_t bytes) { budget = bytes; }
+    size_t getBudget() const { return budget; }
+    size_t getResidentBytes() const { return residentBytes; }
+    size_t getResidentPages() const { return residentPages; }
+    size_t getPagesLoaded() const { return pagesLoaded; }
+    size_t getPagesEvicted() const { return pagesEvicted; }
+    uint32_t getFrame() const { return frame.load(std::memory_order_relaxed); }
+
+private:
+    struct LoadRequest {
+        std::weak_ptr<VirtualTexture> texture;
+        size_t page;
+        std::string file;
+        size_t offset;
+        size_t bytes;
+    };
+
+    struct LoadResult {
+        std::weak_ptr<VirtualTexture> texture;
+        size_t page;
+        std::vector<unsigned char> data; // Empty if the read failed
+    };
+
+    struct EvictionCandidate {
+        uint32_t lastUsedFrame;
+        VirtualTexture* texture;
+        size_t page;
+    };
+
+    void loaderThread();
+    void forget(const VirtualTexture& texture); // Drops the accounting of a dying texture's pages
+    bool makeRoom(size_t bytes, std::vector<EvictionCandidate>& candidates, bool& candidatesBuilt);
+    void evict(VirtualTexture& texture, size_t page);
+
+    std::vector<std::weak_ptr<VirtualTexture>> textures;
+
+    std::mutex mutex;
+    std::vector<std::weak_ptr<VirtualTexture>> registered; // Not yet in `textures`, under the mutex
+    std::condition_variable condition;
+    std::deque<LoadRequest> requests;
+    std::vector<LoadResult> results;
+    bool stop = false;
+    std::thread loader;
+
+    size_t budget;
+    size_t residentBytes = 0;
+    size_t residentPages = 0;
+    size_t pagesLoaded = 0;
+    size_t pagesEvicted = 0;
+    size_t maxPendingLoads = 256; // Bounds the loader queue so stale requests do not pile up
+    std::atomic<uint32_t> frame{1};
+
+    friend class VirtualTexture;
+};
@@ -18,7 +18,13 @@ public:
     ~ThreadPool();
     void enqueue(std::function<void()>&& task);
     void waitForCompletion();
+    // Splits [0, count) into chunks of at least `grain` items, runs body(begin, end) on the
+    // workers and the calling thread, and waits for these chunks only. Runs inline when
+    // called from one of our workers.
+    void parallelFor(int count, int grain, const std::function<void(int, int)>& body);
     int getNumThreads() const { return static_cast<int>(numThreads); }
+    // Index of the calling thread within this pool, -1 if it is not one of our workers
+    int getCurrentWorkerIndex() const;
 
 private:
     uint32_t numThreads;
@@ -29,5 +35,5 @@ private:
     std::condition_variable completionCondition;
     std::atomic<bool> stop;
     std::atomic<size_t> activeTasks;
-    void workerThread();
+    void workerThread(uint32_t index);
 };
\ No newline at end of file
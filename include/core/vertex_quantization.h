@@ -0,0 +1,91 @@
+// include/core/vertex_quantization.h
+#pragma once
+#include "math/vector.h"
+#include "core/texture/texel_format.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+// Compact vertex (18 bytes instead of the 56 of the float streams):
+//  - position: 16-bit unsigned fixed point across the model's bounding box,
+//  - normal and tangent: octahedral encoding, two 16-bit snorm values each;
+//    the lowest bit of the tangent's second value is the bitangent sign,
+//    the bitangent being rebuilt as sign * cross(normal, tangent),
+//  - texture coordinates: half floats.
+struct QuantizedVertex {
+    uint16_t position[3];
+    uint16_t uv[2];
+    int16_t normal[2];
+    int16_t tangent[2];
+};
+
+static_assert(sizeof(QuantizedVertex) == 18, "QuantizedVertex must not be padded");
+
+// --- Octahedral unit vectors ---
+
+inline int16_t encodeSnorm16(float value) {
+    return static_cast<int16_t>(std::lround(std::clamp(value, -1.0f, 1.0f) * 32767.0f));
+}
+
+inline float decodeSnorm16(int16_t value) {
+    return std::max(static_cast<float>(value) * (1.0f / 32767.0f), -1.0f);
+}
+
+// Projects the unit vector onto the octahedron |x| + |y| + |z| = 1 and unfolds
+// the lower half over the corners, giving two values in [-1, 1]
+inline void encodeOctahedral(const vec3f& v, int16_t out[2]) {
+    float invL1 = 1.0f / std::max(std::abs(v.x) + std::abs(v.y) + std::abs(v.z), 1e-20f);
+    float x = v.x * invL1, y = v.y * invL1;
+    if (v.z < 0.0f) {
+        float foldedX = (1.0f - std::abs(y)) * (x >= 0.0f ? 1.0f : -1.0f);
+        float foldedY = (1.0f - std::abs(x)) * (y >= 0.0f ? 1.0f : -1.0f);
+        x = foldedX;
+        y = foldedY;
+    }
+    out[0] = encodeSnorm16(x);
+    out[1] = encodeSnorm16(y);
+}
+
+inline vec3f decodeOctahedral(float x, float y) {
+    vec3f v(x, y, 1.0f - std::abs(x) - std::abs(y));
+    float fold = std::max(-v.z, 0.0f);
+    v.x += v.x >= 0.0f ? -fold : fold;
+    v.y += v.y >= 0.0f ? -fold : fold;
+    return v.normalized();
+}
+
+// --- Whole vertices ---
+
+// Size of one position step on each axis of the bounding box
+inline vec3f quantizationStep(const vec3f& boundsMin, const vec3f& boundsMax) {
+    return (boundsMax - boundsMin) * (1.0f / 65535.0f);
+}
+
+inline QuantizedVertex quantizeVertex(const vec3f& position, const vec3f& normal, const vec2f& uv, const vec3f& tangent,
+                                      const vec3f& bitangent, const vec3f& boundsMin, const vec3f& boundsMax) {
+    QuantizedVertex q;
+    const float p[3] = {position.x, position.y, position.z};
+    const float lo[3] = {boundsMin.x, boundsMin.y, boundsMin.z};
+    const float hi[3] = {boundsMax.x, boundsMax.y, boundsMax.z};
+    for (int axis = 0; axis < 3; ++axis) {
+        float extent = hi[axis] - lo[axis];
+        float t = extent > 0.0f ? (p[axis] - lo[axis]) / extent : 0.0f;
+        q.position[axis] = static_cast<uint16_t>(std::lround(std::clamp(t, 0.0f, 1.0f) * 65535.0f));
+    }
+    q.uv[0] = floatToHalf(uv.x);
+    q.uv[1] = floatToHalf(uv.y);
+    encodeOctahedral(normal, q.normal);
+    encodeOctahedral(tangent, q.tangent);
+    bool flipped = normal.cross(tangent).dot(bitangent) < 0.0f;
+    q.tangent[1] = static_cast<int16_t>((q.tangent[1] & ~1) | (flipped ? 1 : 0));
+    return q;
+}
+
+inline void dequantizeVertex(const QuantizedVertex& q, const vec3f& boundsMin, const vec3f& step, vec3f& position,
+                             vec3f& normal, vec2f& uv, vec3f& tangent, vec3f& bitangent) {
+    position = vec3f(boundsMin.x + q.position[0] * step.x, boundsMin.y + q.position[1] * step.y, boundsMin.z + q.position[2] * step.z);
+    uv = vec2f(halfToFloat(q.uv[0]), halfToFloat(q.uv[1]));
+    normal = decodeOctahedral(decodeSnorm16(q.normal[0]), decodeSnorm16(q.normal[1]));
+    tangent = decodeOctahedral(decodeSnorm16(q.tangent[0]), decodeSnorm16(q.tangent[1]));
+    bitangent = normal.cross(tangent) * ((q.tangent[1] & 1) ? -1.0f : 1.0f);
+}
@@ -0,0 +1,29 @@
+// include/io/cache_file.h
+#pragma once
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <string>
+
+// Rules shared by the on-disk caches (TextureCacheFile, MeshCacheFile): how a
+// source is named in cache keys, when a cache file is stale, where it lives and
+// how it is written.
+namespace CacheFile {
+
+// Absolute, generic-format path of the source (as given if that fails);
+// cache keys start with it, followed by the load options
+std::string sourceKey(const std::string& filename);
+
+// Size and last write time (in file clock ticks) of the source, stored in
+// the cache file and compared on load. False if the source is missing
+bool sourceStamp(const std::string& filename, uint64_t& size, int64_t& time);
+
+// <cacheDirectory>/<64-bit FNV-1a of the key, in hex><extension>
+std::string path(const std::string& cacheDirectory, const std::string& key, const std::string& extension);
+
+// Creates the directory of `path`, lets `write` fill a temporary file next
+// to it and renames that into place, so readers never map a partial file.
+// The temporary file is removed if `write` or the stream fails
+bool writeAtomically(const std::string& path, const std::function<bool(std::ofstream&)>& write);
+
+} // namespace CacheFile
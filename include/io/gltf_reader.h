@@ -0,0 +1,49 @@
+// include/io/gltf_reader.h
+#pragma once
+#include "math/transform.h"
+#include "math/vector.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+class Model;
+
+// Material parameters of a glTF asset (metallic-roughness model). Texture
+// entries are image paths resolved against the asset's directory, empty if the
+// material has none or the image is embedded (only files can be loaded).
+struct GltfMaterial {
+    std::string name;
+    vec4f baseColorFactor = vec4f(1.0f, 1.0f, 1.0f, 1.0f);
+    float metallicFactor = 1.0f;
+    float roughnessFactor = 1.0f;
+    std::string baseColorTexture;
+    std::string normalTexture;
+    std::string occlusionTexture;
+    std::string metallicRoughnessTexture;
+};
+
+// One triangle primitive instanced by a node. Nodes instancing the same mesh
+// share its models.
+struct GltfPrimitive {
+    std::shared_ptr<Model> model;
+    int material = -1;   // Index into GltfAsset::materials, -1 for the default material
+    Transform transform; // The node's world transform within the asset
+};
+
+struct GltfAsset {
+    std::vector<GltfPrimitive> primitives;
+    std::vector<GltfMaterial> materials;
+};
+
+// Reads a glTF 2.0 asset: a .glb file, or a .gltf file with external or
+// base64 (data URI) buffers. Binary buffers are memory-mapped, and accessors
+// whose layout matches a model stream (tightly packed float positions and
+// normals, uint32 indices) become views into the mapping instead of copies.
+// Other layouts are converted: narrower indices are widened, normalized
+// integers are scaled, and texture coordinates are flipped to the OBJ
+// convention (v up). TANGENT attributes become tangent and bitangent streams.
+// Only the default scene's nodes (or every mesh, if the asset has no scenes)
+// are read. The models' bounds come from the POSITION accessors (bounding
+// spheres around the boxes); welding, reordering and meshlets are left to the
+// caller. Prints the reason and returns false on malformed input.
+bool readGltf(const std::string& filename, GltfAsset& asset);
@@ -0,0 +1,30 @@
+// include/io/mapped_file.h
+#pragma once
+#include <cstddef>
+#include <memory>
+#include <string>
+
+// Read-only memory mapping of a whole file. Pages are shared with the OS
+// page cache (and other processes mapping the same file) and loaded lazily.
+class MappedFile {
+public:
+    // Returns nullptr if the file cannot be opened or mapped (or is empty)
+    static std::shared_ptr<MappedFile> open(const std::string& filename);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const unsigned char* data() const { return bytes; }
+    size_t size() const { return length; }
+
+private:
+    MappedFile() = default;
+
+    const unsigned char* bytes = nullptr;
+    size_t length = 0;
+#ifdef _WIN32
+    void* fileHandle = nullptr;
+    void* mappingHandle = nullptr;
+#endif
+};
@@ -0,0 +1,15 @@
+// include/io/obj_reader.h
+#pragma once
+#include <string>
+
+class Model;
+class ThreadPool;
+
+// Reads the positions, texture coordinates, normals and faces of a Wavefront
+// OBJ file into the model (replacing its geometry; welding and tangents are
+// left to the caller). The file is memory-mapped and split at line boundaries
+// into chunks that are parsed in parallel on the pool, then merged in file order.
+// Faces may use v, v/t, v//n or v/t/n corners with absolute or negative
+// (relative) indices; polygons are fan triangulated. Omitted texture or normal
+// indices are -1. Prints the reason and returns false on malformed input.
+bool readObj(const std::string& filename, Model& model, ThreadPool* pool = nullptr);
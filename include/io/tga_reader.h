@@ -0,0 +1,40 @@
+// include/io/tga_reader.h
+#pragma once
+#include "io/mapped_file.h"
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Streaming decoder for true-color and grayscale TGA files (types 2, 3, 10, 11;
+// 8, 24 or 32 bits per pixel, raw or RLE). The file is memory-mapped and handed
+// out one row at a time: raw rows point straight into the mapping, RLE rows are
+// expanded into a single reused row buffer, so there is no whole-image copy.
+class TGAReader {
+public:
+    // Maps the file and validates the header; prints the reason on failure
+    bool open(const std::string& filename);
+
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+    int getChannels() const { return bytesPerPixel; } // 1 (gray), 3 (BGR) or 4 (BGRA)
+
+    // Calls consumer(y, pixels) once per row with getWidth() pixels in file
+    // channel order, left to right. Rows are numbered bottom-up (row 0 is the
+    // bottom of the image, like v in texture coordinates) whatever the origin
+    // stored in the file. False if the pixel data is truncated or corrupt.
+    bool decodeRows(const std::function<void(int y, const unsigned char* pixels)>& consumer) const;
+
+private:
+    bool decodeRLE(const std::function<void(int y, const unsigned char* pixels)>& consumer, std::vector<unsigned char>& row) const;
+
+    std::shared_ptr<MappedFile> file;
+    std::string filename;
+    size_t pixelOffset = 0;
+    int width = 0;
+    int height = 0;
+    int bytesPerPixel = 0;
+    bool rle = false;
+    bool topToBottom = false; // Descriptor bit 5: first row in the file is the top one
+    bool rightToLeft = false; // Descriptor bit 4
+};
@@ -21,4 +21,3 @@ struct TGAHeader {
 };
 #pragma pack(pop)
 
-bool loadTGA(const std::string& filename, int& width, int& height, std::vector<unsigned char>& data);
@@ -0,0 +1,106 @@
+// src/core/arena.cpp
+#include "core/arena.h"
+#include "core/threadpool.h"
+#include <algorithm>
+
+LinearArena::LinearArena(size_t blockSize)
+    : blockSize(std::max<size_t>(blockSize, 4096)) {
+}
+
+void LinearArena::addBlock(size_t minSize) {
+    Block block;
+    block.size = std::max(blockSize, minSize);
+    block.memory = std::make_unique<std::byte[]>(block.size);
+    blocks.push_back(std::move(block));
+}
+
+void* LinearArena::allocate(size_t bytes, size_t alignment) {
+    if (bytes == 0) bytes = 1;
+
+    while (true) {
+        if (currentBlock < blocks.size()) {
+            Block& block = blocks[currentBlock];
+            uintptr_t base = reinterpret_cast<uintptr_t>(block.memory.get());
+            uintptr_t aligned = (base + offset + alignment - 1) & ~(static_cast<uintptr_t>(alignment) - 1);
+            size_t newOffset = (aligned - base) + bytes;
+            if (newOffset <= block.size) {
+                used += newOffset - offset;
+                offset = newOffset;
+                highWaterMark = std::max(highWaterMark, used);
+                return reinterpret_cast<void*>(aligned);
+            }
+            // Current block exhausted, move on to the next one
+            used += block.size - offset;
+            ++currentBlock;
+            offset = 0;
+            continue;
+        }
+        addBlock(bytes + alignment);
+    }
+}
+
+void LinearArena::reset() {
+    if (blocks.size() > 1) {
+        // Frame spilled over several blocks: replace them with a single block
+        // so the next frame with the same footprint never has to chain.
+        size_t total = std::max(getCapacity(), highWaterMark);
+        blocks.clear();
+        addBlock(total);
+    }
+    currentBlock = 0;
+    offset = 0;
+    used = 0;
+}
+
+size_t LinearArena::getCapacity() const {
+    size_t capacity = 0;
+    for (const auto& block : blocks) capacity += block.size;
+    return capacity;
+}
+
+
+FrameArenas::FrameArenas(ThreadPool& tp, size_t blockSize)
+    : threadPool(tp), blockSize(blockSize) {
+    size_t count = static_cast<size_t>(std::max(0, tp.getNumThreads()));
+    arenas.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        arenas.emplace_back(blockSize);
+    }
+}
+
+LinearArena& FrameArenas::local() {
+    int index = threadPool.getCurrentWorkerIndex();
+    if (index >= 0 && index < static_cast<int>(arenas.size())) {
+        return arenas[index];
+    }
+    // Not one of our workers: the thread's own arena, created on first use
+    std::thread::id thread = std::this_thread::get_id();
+    std::lock_guard<std::mutex> lock(threadArenasMutex);
+    for (auto& [id, arena] : threadArenas) {
+        if (id == thread) return *arena;
+    }
+    threadArenas.emplace_back(thread, std::make_unique<LinearArena>(blockSize));
+    return *threadArenas.back().second;
+}
+
+void FrameArenas::reset() {
+    for (auto& arena : arenas) arena.reset();
+    std::lock_guard<std::mutex> lock(threadArenasMutex);
+    for (auto& entry : threadArenas) entry.second->reset();
+}
+
+size_t FrameArenas::getUsed() const {
+    size_t total = 0;
+    for (const auto& arena : arenas) total += arena.getUsed();
+    std::lock_guard<std::mutex> lock(threadArenasMutex);
+    for (const auto& entry : threadArenas) total += entry.second->getUsed();
+    return total;
+}
+
+size_t FrameArenas::getHighWaterMark() const {
+    size_t total = 0;
+    for (const auto& arena : arenas) total += arena.getHighWaterMark();
+    std::lock_guard<std::mutex> lock(threadArenasMutex);
+    for (const auto& entry : threadArenas) total += entry.second->getHighWaterMark();
+    return total;
+}
@@ -1,5 +1,6 @@
 // src/core/blinn_phong_shader.cpp
 #include "core/blinn_phong_shader.h"
+#include "core/texture/material_sampler.h"
 #include <cmath>
 #include <algorithm>
 
@@ -46,15 +47,19 @@ Varyings BlinnPhongShader::vertex(const VertexInput& input) {
 
 bool BlinnPhongShader::fragment(const Varyings& input, vec3f& outColor,
     const vec2f& uv_ddx, const vec2f& uv_ddy)  {
+    // One LOD / footprint computation shared by all maps of the material
+    MaterialSampler maps(input.uv.x, input.uv.y, uv_ddx, uv_ddy);
+
     // --- Determine Normal ---
     vec3f N;
     if (uniform_UseNormalMap && uniform_NormalTexture) {
-        // Sample normal map (returns color in [0, 1] range)
-        vec3f tangentNormalSample = uniform_NormalTexture->sample(input.uv.x, input.uv.y, uv_ddx, uv_ddy);
-
-        // Map color [0, 1] to normal vector [-1, 1]
-        vec3f tangentNormal = (tangentNormalSample * 2.0f) - vec3f(1.0f, 1.0f, 1.0f);
-        tangentNormal = tangentNormal.normalized(); // Ensure it's a unit vector
+        vec3f tangentNormal = maps.sample(*uniform_NormalTexture);
+        if (!uniform_NormalMapTwoChannel) {
+            // RGB normal map (e.g. kept BC1/BC3): map color [0, 1] to normal vector [-1, 1]
+            tangentNormal = (tangentNormal * 2.0f) - vec3f(1.0f, 1.0f, 1.0f);
+            tangentNormal = tangentNormal.normalized(); // Ensure it's a unit vector
+        }
+        // Two-channel maps already return a unit normal with Z rebuilt from X and Y
 
         // Get interpolated TBN basis vectors (renormalize after interpolation)
         vec3f T = input.tangent.normalized();
@@ -75,20 +80,28 @@ bool BlinnPhongShader::fragment(const Varyings& input, vec3f& outColor,
     // Diffuse Color (with texture modulation)
     vec3f matDiffuse = uniform_DiffuseColor;
     if (uniform_UseDiffuseMap) {
-        matDiffuse = matDiffuse * uniform_DiffuseTexture->sample(input.uv.x, input.uv.y, uv_ddx, uv_ddy);
+        matDiffuse = matDiffuse * maps.sample(*uniform_DiffuseTexture);
+    }
+
+    // Packed scalar maps: one fetch for specular (R), gloss (G) and AO (B)
+    vec3f packedScalars(0.0f, 0.0f, 0.0f);
+    if (uniform_UsePackedSpecular || uniform_UsePackedGloss || uniform_UsePackedAo) {
+        packedScalars = maps.sample(*uniform_PackedScalarTexture);
     }
 
     // Specular Color (with texture override)
     vec3f matSpecular = uniform_SpecularColor;
-    if (uniform_UseSpecularMap) {
-        matSpecular = uniform_SpecularTexture->sample(input.uv.x, input.uv.y, uv_ddx, uv_ddy); // Use map value
+    if (uniform_UsePackedSpecular) {
+        matSpecular = vec3f(packedScalars.x, packedScalars.x, packedScalars.x);
+    } else if (uniform_UseSpecularMap) {
+        matSpecular = maps.sample(*uniform_SpecularTexture); // Use map value
     }
 
     // Shininess/Gloss (with texture override)
     int currentShininess = uniform_Shininess; // Default
-    if (uniform_UseGlossMap) {
+    if (uniform_UsePackedGloss || uniform_UseGlossMap) {
         // Sample gloss map (assume single channel, e.g., .x)
-        float glossFactor = uniform_GlossTexture->sample(input.uv.x, input.uv.y, uv_ddx, uv_ddy).x;
+        float glossFactor = uniform_UsePackedGloss ? packedScalars.y : maps.sample(*uniform_GlossTexture).x;
         glossFactor = std::max(0.0f, std::min(1.0f, glossFactor)); // Clamp [0, 1]
 
         // Map gloss [0, 1] to shininess range [min, max]
@@ -105,9 +118,9 @@ bool BlinnPhongShader::fragment(const Varyings& input, vec3f& outColor,
 
     // --- Ambient Occlusion ---
     float aoFactor = 1.0f; // Default: no occlusion
-    if (uniform_UseAoMap) {
+    if (uniform_UsePackedAo || uniform_UseAoMap) {
         // Sample AO map (assume single channel, e.g., .x)
-        aoFactor = uniform_AoTexture->sample(input.uv.x, input.uv.y, uv_ddx, uv_ddy).x;
+        aoFactor = uniform_UsePackedAo ? packedScalars.z : maps.sample(*uniform_AoTexture).x;
         aoFactor = std::max(0.0f, std::min(1.0f, aoFactor)); // Clamp [0, 1]
     }
 
@@ -0,0 +1,91 @@
+// src/core/depth_pyramid.cpp
+#include "core/depth_pyramid.h"
+#include "core/threadpool.h"
+#include <algorithm>
+#include <cmath>
+
+#ifndef NaiveMethod
+#include <immintrin.h>
+#endif
+
+namespace { // Anonymous namespace for internal linkage helper functions
+
+    // Texels of the finest level a rectangle may cover per axis before a coarser level is used
+    constexpr int MaxTestTexels = 4;
+
+    // One level from the one below (or the depth buffer): farthest of each 2x2
+    // block. On odd sizes the last texel of a row or column covers a single one.
+    void reduceRows(const float* src, int srcWidth, int srcHeight, float* dst, int dstWidth, int yBegin, int yEnd) {
+        for (int y = yBegin; y < yEnd; ++y) {
+            int y0 = y * 2;
+            int y1 = std::min(y0 + 1, srcHeight - 1);
+            const float* row0 = src + static_cast<size_t>(y0) * srcWidth;
+            const float* row1 = src + static_cast<size_t>(y1) * srcWidth;
+            float* out = dst + static_cast<size_t>(y) * dstWidth;
+            int x = 0;
+#ifndef NaiveMethod
+            // Four output texels from eight input columns of both rows
+            for (; x + 4 <= dstWidth && x * 2 + 8 <= srcWidth; x += 4) {
+                __m128 a = _mm_max_ps(_mm_loadu_ps(row0 + x * 2), _mm_loadu_ps(row1 + x * 2));
+                __m128 b = _mm_max_ps(_mm_loadu_ps(row0 + x * 2 + 4), _mm_loadu_ps(row1 + x * 2 + 4));
+                __m128 even = _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0));
+                __m128 odd = _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1));
+                _mm_storeu_ps(out + x, _mm_max_ps(even, odd));
+            }
+#endif
+            for (; x < dstWidth; ++x) {
+                int x0 = x * 2;
+                int x1 = std::min(x0 + 1, srcWidth - 1);
+                out[x] = std::max(std::max(row0[x0], row0[x1]), std::max(row1[x0], row1[x1]));
+            }
+        }
+    }
+
+} // end anonymous namespace
+
+void DepthPyramid::build(const std::vector<float>& depth, int width, int height, ThreadPool* pool) {
+    levels.clear();
+    const float* src = depth.data();
+    int srcWidth = width, srcHeight = height;
+    while (srcWidth > 1 || srcHeight > 1) {
+        Level level;
+        level.width = (srcWidth + 1) / 2;
+        level.height = (srcHeight + 1) / 2;
+        level.depth.resize(static_cast<size_t>(level.width) * level.height);
+        auto body = [&](int begin, int end) { reduceRows(src, srcWidth, srcHeight, level.depth.data(), level.width, begin, end); };
+        if (pool && level.height >= 64) pool->parallelFor(level.height, 16, body);
+        else body(0, level.height);
+        levels.push_back(std::move(level));
+        src = levels.back().depth.data();
+        srcWidth = levels.back().width;
+        srcHeight = levels.back().height;
+    }
+}
+
+bool DepthPyramid::isOccluded(float minX, float minY, float maxX, float maxY, float nearestDepth) const {
+    if (levels.empty()) return false;
+    int x0 = std::max(0, static_cast<int>(std::floor(minX)));
+    int y0 = std::max(0, static_cast<int>(std::floor(minY)));
+    int x1 = static_cast<int>(std::ceil(maxX));
+    int y1 = static_cast<int>(std::ceil(maxY));
+
+    // Level 0 texels are 2x2 pixels; go up until the rectangle spans few texels
+    size_t index = 0;
+    x0 >>= 1; y0 >>= 1; x1 >>= 1; y1 >>= 1;
+    while (index + 1 < levels.size() && (x1 - x0 >= MaxTestTexels || y1 - y0 >= MaxTestTexels)) {
+        x0 >>= 1; y0 >>= 1; x1 >>= 1; y1 >>= 1;
+        ++index;
+    }
+    const Level& level = levels[index];
+    x1 = std::min(x1, level.width - 1);
+    y1 = std::min(y1, level.height - 1);
+    if (x0 > x1 || y0 > y1) return false; // Off screen: left to frustum culling
+
+    for (int y = y0; y <= y1; ++y) {
+        const float* row = level.depth.data() + static_cast<size_t>(y) * level.width;
+        for (int x = x0; x <= x1; ++x) {
+            if (nearestDepth < row[x]) return false; // Something there is farther: may be visible
+        }
+    }
+    return true;
+}
@@ -0,0 +1,75 @@
+// src/core/frustum.cpp
+#include "core/frustum.h"
+#include <algorithm>
+#include <cmath>
+
+#ifndef NaiveMethod
+#include <immintrin.h>
+#endif
+
+Frustum::Frustum(const mat4& matrix) {
+    const float (&m)[4][4] = matrix.m;
+    for (int axis = 0; axis < 3; ++axis) {
+        for (int side = 0; side < 2; ++side) {
+            int i = axis * 2 + side;
+            float sign = side == 0 ? 1.0f : -1.0f;
+            a[i] = m[3][0] + sign * m[axis][0];
+            b[i] = m[3][1] + sign * m[axis][1];
+            c[i] = m[3][2] + sign * m[axis][2];
+            d[i] = m[3][3] + sign * m[axis][3];
+            float length = std::sqrt(a[i] * a[i] + b[i] * b[i] + c[i] * c[i]);
+            if (length > 0.0f) {
+                float invLength = 1.0f / length;
+                a[i] *= invLength;
+                b[i] *= invLength;
+                c[i] *= invLength;
+                d[i] *= invLength;
+            }
+        }
+    }
+}
+
+bool Frustum::sphereOutside(const vec3f& center, float radius) const {
+#ifndef NaiveMethod
+    __m128 x = _mm_set1_ps(center.x), y = _mm_set1_ps(center.y), z = _mm_set1_ps(center.z);
+    __m128 negRadius = _mm_set1_ps(-radius);
+    int outside = 0;
+    for (int i = 0; i < 8; i += 4) {
+        __m128 distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_load_ps(a + i), x), _mm_mul_ps(_mm_load_ps(b + i), y)),
+                                     _mm_add_ps(_mm_mul_ps(_mm_load_ps(c + i), z), _mm_load_ps(d + i)));
+        outside |= _mm_movemask_ps(_mm_cmplt_ps(distance, negRadius));
+    }
+    return outside != 0;
+#else
+    for (int i = 0; i < 6; ++i) {
+        if (a[i] * center.x + b[i] * center.y + c[i] * center.z + d[i] < -radius) return true;
+    }
+    return false;
+#endif
+}
+
+// Tests the corner farthest along each plane's normal (the "positive vertex"):
+// per axis, the larger of the products with the box's two extents
+bool Frustum::boxOutside(const vec3f& boxMin, const vec3f& boxMax) const {
+#ifndef NaiveMethod
+    __m128 minX = _mm_set1_ps(boxMin.x), minY = _mm_set1_ps(boxMin.y), minZ = _mm_set1_ps(boxMin.z);
+    __m128 maxX = _mm_set1_ps(boxMax.x), maxY = _mm_set1_ps(boxMax.y), maxZ = _mm_set1_ps(boxMax.z);
+    int outside = 0;
+    for (int i = 0; i < 8; i += 4) {
+        __m128 planeA = _mm_load_ps(a + i), planeB = _mm_load_ps(b + i), planeC = _mm_load_ps(c + i);
+        __m128 distance = _mm_add_ps(_mm_max_ps(_mm_mul_ps(planeA, minX), _mm_mul_ps(planeA, maxX)),
+                                     _mm_max_ps(_mm_mul_ps(planeB, minY), _mm_mul_ps(planeB, maxY)));
+        distance = _mm_add_ps(distance, _mm_add_ps(_mm_max_ps(_mm_mul_ps(planeC, minZ), _mm_mul_ps(planeC, maxZ)),
+                                                   _mm_load_ps(d + i)));
+        outside |= _mm_movemask_ps(_mm_cmplt_ps(distance, _mm_setzero_ps()));
+    }
+    return outside != 0;
+#else
+    for (int i = 0; i < 6; ++i) {
+        float distance = std::max(a[i] * boxMin.x, a[i] * boxMax.x) + std::max(b[i] * boxMin.y, b[i] * boxMax.y) +
+                         std::max(c[i] * boxMin.z, c[i] * boxMax.z) + d[i];
+        if (distance < 0.0f) return true;
+    }
+    return false;
+#endif
+}
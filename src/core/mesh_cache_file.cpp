@@ -0,0 +1,196 @@
+// src/core/mesh_cache_file.cpp
+#include "core/mesh_cache_file.h"
+#include "io/cache_file.h"
+#include "io/mapped_file.h"
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+namespace { // Anonymous namespace for internal linkage helper functions
+
+    constexpr uint32_t CacheMagic = 0x434d5253u; // "SRMC"
+    constexpr uint32_t CacheVersion = 6;          // 3: optimizeMesh order, 4: meshlets, 5: quantized vertices, 6: bounding sphere
+    constexpr size_t DataAlignment = 64;         // Stream offsets, keeps vertices cache line aligned
+
+    enum class StreamId : uint32_t {
+        Positions, Normals, UVs, Tangents, Bitangents, Indices, Meshlets, MeshletVertices, MeshletTriangles, QuantizedVertices, Count
+    };
+
+    struct FileHeader {
+        uint32_t magic;
+        uint32_t version;
+        uint64_t sourceSize;
+        int64_t sourceTime;  // Source last write time, in file clock ticks
+        uint32_t keyLength;  // Followed by the key (absolute source path)
+        uint32_t numStreams; // Then numStreams FileStream entries, then the aligned stream data
+        float boundsMin[3];
+        float boundsMax[3];
+        float boundsRadius;
+        uint32_t reserved;
+    };
+
+    struct FileStream {
+        uint32_t id;          // StreamId
+        uint32_t elementSize; // Checked against the element type on load
+        uint64_t count;
+        uint64_t offset;
+        uint64_t reserved;
+    };
+
+    static_assert(sizeof(FileHeader) == 64 && sizeof(FileStream) == 32, "Cache file structs must not be padded");
+    static_assert(sizeof(Model::Meshlet) == 48, "Meshlets are stored as they are in memory");
+
+    std::string cacheKeyFor(const std::string& filename, const ModelLoadOptions& options) {
+        return options.cacheKey(CacheFile::sourceKey(filename));
+    }
+
+    // Points the array into the mapping if the stream table has a well-formed entry for it
+    template <typename T>
+    bool mapStream(const std::shared_ptr<const MappedFile>& file, const FileStream (&streams)[static_cast<size_t>(StreamId::Count)],
+                   StreamId id, MeshArray<T>& array) {
+        const FileStream& stream = streams[static_cast<size_t>(id)];
+        if (stream.elementSize != sizeof(T) || stream.offset % alignof(T) != 0 || stream.offset > file->size() ||
+            stream.count > (file->size() - stream.offset) / sizeof(T)) {
+            return false;
+        }
+        array = MeshArray<T>::mapped(file, reinterpret_cast<const T*>(file->data() + stream.offset), static_cast<size_t>(stream.count));
+        return true;
+    }
+
+} // end anonymous namespace
+
+std::string MeshCacheFile::cachePath(const std::string& cacheDirectory, const std::string& filename, const ModelLoadOptions& options) {
+    return CacheFile::path(cacheDirectory, cacheKeyFor(filename, options), ".meshcache");
+}
+
+std::shared_ptr<Model> MeshCacheFile::load(const std::string& cacheDirectory, const std::string& filename, const ModelLoadOptions& options) {
+    uint64_t sourceSize;
+    int64_t sourceTime;
+    if (!CacheFile::sourceStamp(filename, sourceSize, sourceTime)) return nullptr;
+
+    std::shared_ptr<const MappedFile> file = MappedFile::open(cachePath(cacheDirectory, filename, options));
+    if (!file || file->size() < sizeof(FileHeader)) return nullptr;
+
+    FileHeader header;
+    std::memcpy(&header, file->data(), sizeof(header));
+    std::string key = cacheKeyFor(filename, options);
+    if (header.magic != CacheMagic || header.version != CacheVersion) return nullptr;
+    if (header.sourceSize != sourceSize || header.sourceTime != sourceTime) return nullptr; // Source changed: stale
+    constexpr size_t numStreams = static_cast<size_t>(StreamId::Count);
+    size_t tableOffset = sizeof(FileHeader) + header.keyLength;
+    if (header.keyLength != key.size() || header.numStreams != numStreams ||
+        tableOffset + numStreams * sizeof(FileStream) > file->size() ||
+        std::memcmp(file->data() + sizeof(FileHeader), key.data(), key.size()) != 0) {
+        return nullptr; // Hash collision or truncated file
+    }
+
+    FileStream streams[numStreams];
+    for (size_t i = 0; i < numStreams; ++i) {
+        std::memcpy(&streams[i], file->data() + tableOffset + i * sizeof(FileStream), sizeof(FileStream));
+        if (streams[i].id != i) return nullptr;
+    }
+
+    auto model = std::make_shared<Model>();
+    if (!mapStream(file, streams, StreamId::Positions, model->vertices) ||
+        !mapStream(file, streams, StreamId::Normals, model->normals) ||
+        !mapStream(file, streams, StreamId::UVs, model->uvs) ||
+        !mapStream(file, streams, StreamId::Tangents, model->tangents) ||
+        !mapStream(file, streams, StreamId::Bitangents, model->bitangents) ||
+        !mapStream(file, streams, StreamId::Indices, model->indices) ||
+        !mapStream(file, streams, StreamId::Meshlets, model->meshlets) ||
+        !mapStream(file, streams, StreamId::MeshletVertices, model->meshletVertices) ||
+        !mapStream(file, streams, StreamId::MeshletTriangles, model->meshletTriangles) ||
+        !mapStream(file, streams, StreamId::QuantizedVertices, model->quantizedVertices)) {
+        return nullptr;
+    }
+    // Either five float streams of equal length, or only the quantized one
+    size_t numVertices = model->vertices.size();
+    bool floatStreamsMatch = model->normals.size() == numVertices && model->uvs.size() == numVertices &&
+                             model->tangents.size() == numVertices && model->bitangents.size() == numVertices;
+    if (model->isQuantized() != options.quantize || (options.quantize ? numVertices != 0 || !floatStreamsMatch : !floatStreamsMatch) ||
+        model->indices.size() % 3 != 0) {
+        return nullptr;
+    }
+    // The renderer does not check vertex numbers: validate them once here
+    size_t vertexCount = model->numVertices();
+    auto outOfRange = [vertexCount](const MeshArray<uint32_t>& vertexIndices) {
+        return !vertexIndices.empty() && *std::max_element(vertexIndices.begin(), vertexIndices.end()) >= vertexCount;
+    };
+    if (outOfRange(model->indices) || outOfRange(model->meshletVertices)) return nullptr;
+    for (const Model::Meshlet& meshlet : model->meshlets) {
+        size_t triangleBytes = static_cast<size_t>(meshlet.triangleCount) * 3;
+        if (meshlet.vertexCount > Model::MaxMeshletVertices || meshlet.triangleCount > Model::MaxMeshletTriangles ||
+            meshlet.vertexCount > model->meshletVertices.size() || triangleBytes > model->meshletTriangles.size() ||
+            meshlet.vertexOffset > model->meshletVertices.size() - meshlet.vertexCount ||
+            meshlet.triangleOffset > model->meshletTriangles.size() - triangleBytes) {
+            return nullptr; // Would read past the meshlet streams
+        }
+        const uint8_t* triangles = std::as_const(model->meshletTriangles).data() + meshlet.triangleOffset;
+        if (triangleBytes > 0 && *std::max_element(triangles, triangles + triangleBytes) >= meshlet.vertexCount) {
+            return nullptr; // Local vertex outside the meshlet
+        }
+    }
+    model->boundsMin = vec3f(header.boundsMin[0], header.boundsMin[1], header.boundsMin[2]);
+    model->boundsMax = vec3f(header.boundsMax[0], header.boundsMax[1], header.boundsMax[2]);
+    model->boundsRadius = header.boundsRadius;
+    return model;
+}
+
+bool MeshCacheFile::store(const std::string& cacheDirectory, const std::string& filename, const Model& model,
+                          const ModelLoadOptions& options) {
+    uint64_t sourceSize;
+    int64_t sourceTime;
+    if (!model.faces.empty() || model.isQuantized() != options.quantize || !CacheFile::sourceStamp(filename, sourceSize, sourceTime)) return false; // Only welded models
+
+    std::string key = cacheKeyFor(filename, options);
+    constexpr size_t numStreams = static_cast<size_t>(StreamId::Count);
+    FileHeader header = {};
+    header.magic = CacheMagic;
+    header.version = CacheVersion;
+    header.sourceSize = sourceSize;
+    header.sourceTime = sourceTime;
+    header.keyLength = static_cast<uint32_t>(key.size());
+    header.numStreams = static_cast<uint32_t>(numStreams);
+    const float boundsMin[3] = {model.boundsMin.x, model.boundsMin.y, model.boundsMin.z};
+    const float boundsMax[3] = {model.boundsMax.x, model.boundsMax.y, model.boundsMax.z};
+    std::memcpy(header.boundsMin, boundsMin, sizeof(boundsMin));
+    std::memcpy(header.boundsMax, boundsMax, sizeof(boundsMax));
+    header.boundsRadius = model.boundsRadius;
+
+    // Stream payloads in StreamId order
+    const void* payloads[numStreams] = {model.vertices.data(), model.normals.data(), model.uvs.data(),
+                                        model.tangents.data(), model.bitangents.data(), model.indices.data(),
+                                        model.meshlets.data(), model.meshletVertices.data(), model.meshletTriangles.data(),
+                                        model.quantizedVertices.data()};
+    const size_t counts[numStreams] = {model.vertices.size(), model.normals.size(), model.uvs.size(),
+                                       model.tangents.size(), model.bitangents.size(), model.indices.size(),
+                                       model.meshlets.size(), model.meshletVertices.size(), model.meshletTriangles.size(),
+                                       model.quantizedVertices.size()};
+    const size_t elementSizes[numStreams] = {sizeof(vec3f), sizeof(vec3f), sizeof(vec2f), sizeof(vec3f), sizeof(vec3f), sizeof(uint32_t),
+                                             sizeof(Model::Meshlet), sizeof(uint32_t), sizeof(uint8_t), sizeof(QuantizedVertex)};
+
+    FileStream table[numStreams] = {};
+    uint64_t offset = sizeof(FileHeader) + key.size() + sizeof(table);
+    for (size_t i = 0; i < numStreams; ++i) {
+        offset = (offset + DataAlignment - 1) & ~static_cast<uint64_t>(DataAlignment - 1);
+        table[i].id = static_cast<uint32_t>(i);
+        table[i].elementSize = static_cast<uint32_t>(elementSizes[i]);
+        table[i].count = counts[i];
+        table[i].offset = offset;
+        offset += counts[i] * elementSizes[i];
+    }
+
+    return CacheFile::writeAtomically(cachePath(cacheDirectory, filename, options), [&](std::ofstream& out) {
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(key.data(), static_cast<std::streamsize>(key.size()));
+        out.write(reinterpret_cast<const char*>(table), sizeof(table));
+        const char padding[DataAlignment] = {};
+        uint64_t written = sizeof(FileHeader) + key.size() + sizeof(table);
+        for (size_t i = 0; i < numStreams; ++i) {
+            out.write(padding, static_cast<std::streamsize>(table[i].offset - written));
+            out.write(static_cast<const char*>(payloads[i]), static_cast<std::streamsize>(counts[i] * elementSizes[i]));
+            written = table[i].offset + counts[i] * elementSizes[i];
+        }
+        return true;
+    });
+}
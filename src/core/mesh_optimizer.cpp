@@ -0,0 +1,326 @@
+// src/core/mesh_optimizer.cpp
+#include "core/mesh_optimizer.h"
+#include "core/model.h"
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+namespace { // Anonymous namespace for internal linkage helper functions
+
+    constexpr uint32_t NoVertex = ~0u;
+
+    // Clusters whose own ACMR has fallen below this are closed early (soft
+    // boundaries): smaller clusters sort better for overdraw, and a cluster
+    // that already amortized its first misses loses little from a cache flush.
+    // 0.65 gives clusters of about 130 triangles on regular meshes, for an
+    // ACMR about 7% above unclustered Tipsify (0.65 against 0.61 at 16 entries).
+    constexpr float ClusterSplitACMR = 0.65f;
+
+    // Vertex -> triangles adjacency in compressed rows
+    struct Adjacency {
+        std::vector<uint32_t> offsets;   // numVertices + 1
+        std::vector<uint32_t> triangles; // numTriangles * 3
+    };
+
+    Adjacency buildAdjacency(const uint32_t* indices, size_t numTriangles, size_t numVertices) {
+        Adjacency adjacency;
+        adjacency.offsets.assign(numVertices + 1, 0);
+        for (size_t i = 0; i < numTriangles * 3; ++i) adjacency.offsets[indices[i] + 1]++;
+        std::partial_sum(adjacency.offsets.begin(), adjacency.offsets.end(), adjacency.offsets.begin());
+        adjacency.triangles.resize(numTriangles * 3);
+        std::vector<uint32_t> fill(adjacency.offsets.begin(), adjacency.offsets.end() - 1);
+        for (size_t t = 0; t < numTriangles; ++t) {
+            for (int c = 0; c < 3; ++c) adjacency.triangles[fill[indices[t * 3 + c]]++] = static_cast<uint32_t>(t);
+        }
+        return adjacency;
+    }
+
+    // Tipsify: fans around a vertex, then continues at the neighbour most likely
+    // to still be cached once its remaining triangles are emitted, and only
+    // jumps (a hard cluster boundary) at dead ends. Returns the triangle order;
+    // clusterStarts receives the position of every jump.
+    std::vector<uint32_t> tipsify(const uint32_t* indices, size_t numTriangles, size_t numVertices, int cacheSize,
+                                  std::vector<size_t>& clusterStarts) {
+        Adjacency adjacency = buildAdjacency(indices, numTriangles, numVertices);
+        std::vector<uint32_t> liveTriangles(numVertices);
+        for (size_t v = 0; v < numVertices; ++v) liveTriangles[v] = adjacency.offsets[v + 1] - adjacency.offsets[v];
+        std::vector<uint32_t> cacheTime(numVertices, 0);
+        std::vector<char> emitted(numTriangles, 0);
+        std::vector<uint32_t> deadEnds, candidates, order;
+        order.reserve(numTriangles);
+        deadEnds.reserve(numTriangles * 3);
+
+        const uint32_t cacheEntries = static_cast<uint32_t>(cacheSize);
+        uint32_t time = cacheEntries + 1;
+        size_t cursor = 0;
+        uint32_t fanning = numVertices > 0 ? 0 : NoVertex;
+        clusterStarts.assign(1, 0);
+
+        while (fanning != NoVertex) {
+            candidates.clear();
+            for (uint32_t k = adjacency.offsets[fanning]; k < adjacency.offsets[fanning + 1]; ++k) {
+                uint32_t t = adjacency.triangles[k];
+                if (emitted[t]) continue;
+                emitted[t] = 1;
+                order.push_back(t);
+                for (int c = 0; c < 3; ++c) {
+                    uint32_t v = indices[t * 3 + c];
+                    deadEnds.push_back(v);
+                    candidates.push_back(v);
+                    liveTriangles[v]--;
+                    if (time - cacheTime[v] > cacheEntries) cacheTime[v] = time++; // Miss: enters the FIFO
+                }
+            }
+
+            // Next fanning vertex: the oldest candidate that stays in the cache
+            // while its remaining triangles (two new vertices each, at most) go out
+            fanning = NoVertex;
+            int64_t bestPriority = -1;
+            for (uint32_t v : candidates) {
+                if (liveTriangles[v] == 0) continue;
+                int64_t priority = 0;
+                if (time - cacheTime[v] + 2 * liveTriangles[v] <= cacheEntries) priority = time - cacheTime[v];
+                if (priority > bestPriority) {
+                    bestPriority = priority;
+                    fanning = v;
+                }
+            }
+            if (fanning != NoVertex) continue;
+
+            // Dead end: recently used vertices first, then the next unfinished one in input order
+            while (!deadEnds.empty() && fanning == NoVertex) {
+                uint32_t v = deadEnds.back();
+                deadEnds.pop_back();
+                if (liveTriangles[v] > 0) fanning = v;
+            }
+            while (fanning == NoVertex && cursor < numVertices) {
+                if (liveTriangles[cursor] > 0) fanning = static_cast<uint32_t>(cursor);
+                ++cursor;
+            }
+            if (fanning != NoVertex && order.size() > clusterStarts.back()) clusterStarts.push_back(order.size());
+        }
+        return order;
+    }
+
+    // Adds soft boundaries inside the hard clusters, where a cluster's own
+    // ACMR (simulated from its first triangle on) drops below ClusterSplitACMR
+    std::vector<size_t> splitClusters(const uint32_t* indices, const std::vector<uint32_t>& order, size_t numVertices,
+                                      int cacheSize, const std::vector<size_t>& hardStarts) {
+        std::vector<size_t> starts;
+        std::vector<uint32_t> cacheTime(numVertices, 0);
+        const uint32_t cacheEntries = static_cast<uint32_t>(cacheSize);
+        uint32_t time = cacheEntries + 1;
+        size_t nextHard = 0;
+        size_t clusterStart = 0, clusterMisses = 0;
+        for (size_t i = 0; i < order.size(); ++i) {
+            bool hard = nextHard < hardStarts.size() && hardStarts[nextHard] == i;
+            bool soft = i > clusterStart && clusterMisses < ClusterSplitACMR * static_cast<float>(i - clusterStart);
+            if (hard || soft || i == 0) {
+                if (hard) ++nextHard;
+                starts.push_back(i);
+                clusterStart = i;
+                clusterMisses = 0;
+                time += cacheEntries + 1; // The cluster may be drawn after any other: assume a cold cache
+            }
+            for (int c = 0; c < 3; ++c) {
+                uint32_t v = indices[order[i] * 3 + c];
+                if (time - cacheTime[v] > cacheEntries) {
+                    cacheTime[v] = time++;
+                    ++clusterMisses;
+                }
+            }
+        }
+        return starts;
+    }
+
+    // Sorts clusters by how far they face away from the model's centroid:
+    // outward facing clusters on the perimeter occlude the rest from most views
+    std::vector<uint32_t> sortClusters(const Model& model, const uint32_t* indices, const std::vector<uint32_t>& order,
+                                       const std::vector<size_t>& starts) {
+        struct Cluster {
+            vec3f centroid = vec3f(0.0f, 0.0f, 0.0f); // Area weighted, divided by area below
+            vec3f normal = vec3f(0.0f, 0.0f, 0.0f);   // Sum of area weighted face normals
+            float area = 0.0f;
+            float key = 0.0f;
+            size_t begin = 0, end = 0;
+        };
+        std::vector<Cluster> clusters(starts.size());
+        vec3f meshCentroid(0.0f, 0.0f, 0.0f);
+        float meshArea = 0.0f;
+        for (size_t c = 0; c < clusters.size(); ++c) {
+            Cluster& cluster = clusters[c];
+            cluster.begin = starts[c];
+            cluster.end = c + 1 < starts.size() ? starts[c + 1] : order.size();
+            for (size_t i = cluster.begin; i < cluster.end; ++i) {
+                const uint32_t* triangle = indices + order[i] * 3;
+                const vec3f& v0 = model.getVertex(triangle[0]);
+                const vec3f& v1 = model.getVertex(triangle[1]);
+                const vec3f& v2 = model.getVertex(triangle[2]);
+                vec3f faceNormal = (v1 - v0).cross(v2 - v0);
+                float area = std::sqrt(faceNormal.lengthSq()) * 0.5f;
+                cluster.normal += faceNormal;
+                cluster.centroid += (v0 + v1 + v2) * (area / 3.0f);
+                cluster.area += area;
+            }
+            meshCentroid += cluster.centroid;
+            meshArea += cluster.area;
+            if (cluster.area > 0.0f) cluster.centroid = cluster.centroid * (1.0f / cluster.area);
+        }
+        if (meshArea > 0.0f) meshCentroid = meshCentroid * (1.0f / meshArea);
+        for (Cluster& cluster : clusters) {
+            if (cluster.normal.lengthSq() > 0.0f) cluster.key = (cluster.centroid - meshCentroid).dot(cluster.normal.normalized());
+        }
+        std::stable_sort(clusters.begin(), clusters.end(), [](const Cluster& a, const Cluster& b) { return a.key > b.key; });
+
+        std::vector<uint32_t> sorted;
+        sorted.reserve(order.size());
+        for (const Cluster& cluster : clusters) sorted.insert(sorted.end(), order.begin() + cluster.begin, order.begin() + cluster.end);
+        return sorted;
+    }
+
+    template <typename T>
+    void remapStream(MeshArray<T>& stream, const std::vector<uint32_t>& newIndex) {
+        if (stream.size() != newIndex.size()) return; // Stream not computed yet (tangents)
+        std::vector<T> remapped(stream.size());
+        for (size_t i = 0; i < newIndex.size(); ++i) remapped[newIndex[i]] = std::as_const(stream)[i];
+        stream = std::move(remapped);
+    }
+
+    // Smallest cosine between the cone axis and a face normal below which a
+    // meshlet is never backface culled (it faces too many directions)
+    constexpr float MinConeCosine = 0.1f;
+
+    // Bounding sphere (around the box of its vertices) and normal cone of a finished meshlet
+    void finishMeshlet(const Model& model, const std::vector<uint32_t>& vertices, const std::vector<uint8_t>& triangles,
+                       Model::Meshlet& meshlet) {
+        const uint32_t* local = vertices.data() + meshlet.vertexOffset;
+        vec3f lo = model.getVertex(local[0]), hi = lo;
+        for (uint32_t i = 1; i < meshlet.vertexCount; ++i) {
+            const vec3f& v = model.getVertex(local[i]);
+            lo = vec3f(std::min(lo.x, v.x), std::min(lo.y, v.y), std::min(lo.z, v.z));
+            hi = vec3f(std::max(hi.x, v.x), std::max(hi.y, v.y), std::max(hi.z, v.z));
+        }
+        meshlet.center = (lo + hi) * 0.5f;
+        float radiusSq = 0.0f;
+        for (uint32_t i = 0; i < meshlet.vertexCount; ++i) radiusSq = std::max(radiusSq, (model.getVertex(local[i]) - meshlet.center).lengthSq());
+        meshlet.radius = std::sqrt(radiusSq);
+
+        // Unit face normals: every triangle counts the same for the cone's width
+        const uint8_t* corners = triangles.data() + meshlet.triangleOffset;
+        std::vector<vec3f> faceNormals;
+        faceNormals.reserve(meshlet.triangleCount);
+        vec3f axis(0.0f, 0.0f, 0.0f);
+        for (uint32_t t = 0; t < meshlet.triangleCount; ++t) {
+            const vec3f& v0 = model.getVertex(local[corners[t * 3]]);
+            vec3f n = (model.getVertex(local[corners[t * 3 + 1]]) - v0).cross(model.getVertex(local[corners[t * 3 + 2]]) - v0);
+            if (n.lengthSq() == 0.0f) continue; // Degenerate: never rasterized, does not widen the cone
+            faceNormals.push_back(n.normalized());
+            axis += faceNormals.back();
+        }
+        meshlet.coneAxis = vec3f(0.0f, 0.0f, 0.0f);
+        meshlet.coneCutoff = 1.0f;
+        if (faceNormals.empty() || axis.lengthSq() == 0.0f) return;
+        axis = axis.normalized();
+        float minCosine = 1.0f;
+        for (const vec3f& n : faceNormals) minCosine = std::min(minCosine, n.dot(axis));
+        if (minCosine <= MinConeCosine) return;
+        meshlet.coneAxis = axis;
+        meshlet.coneCutoff = std::sqrt(1.0f - minCosine * minCosine);
+    }
+
+} // end anonymous namespace
+
+float computeACMR(const uint32_t* indices, size_t numIndices, size_t numVertices, int cacheSize) {
+    if (numIndices < 3) return 0.0f;
+    // A vertex is cached while fewer than cacheSize misses happened since its own
+    std::vector<uint32_t> cacheTime(numVertices, 0);
+    const uint32_t cacheEntries = static_cast<uint32_t>(cacheSize);
+    uint32_t time = cacheEntries + 1;
+    for (size_t i = 0; i < numIndices; ++i) {
+        if (time - cacheTime[indices[i]] > cacheEntries) cacheTime[indices[i]] = time++;
+    }
+    return static_cast<float>(time - cacheEntries - 1) / static_cast<float>(numIndices / 3);
+}
+
+MeshOptimizationStats optimizeMesh(Model& model, int cacheSize) {
+    MeshOptimizationStats stats;
+    const size_t numVertices = model.numVertices();
+    const size_t numTriangles = model.numFaces();
+    if (numTriangles == 0) return stats;
+    const uint32_t* indices = std::as_const(model.indices).data();
+    stats.acmrBefore = computeACMR(indices, numTriangles * 3, numVertices, cacheSize);
+
+    std::vector<size_t> hardStarts;
+    std::vector<uint32_t> order = tipsify(indices, numTriangles, numVertices, cacheSize, hardStarts);
+    std::vector<size_t> clusterStarts = splitClusters(indices, order, numVertices, cacheSize, hardStarts);
+    stats.numClusters = clusterStarts.size();
+    order = sortClusters(model, indices, order, clusterStarts);
+
+    // Renumber vertices by first use in the new triangle order (unused ones last)
+    std::vector<uint32_t> newIndex(numVertices, NoVertex);
+    std::vector<uint32_t> reordered(numTriangles * 3);
+    uint32_t nextVertex = 0;
+    for (size_t i = 0; i < numTriangles; ++i) {
+        for (int c = 0; c < 3; ++c) {
+            uint32_t v = indices[order[i] * 3 + c];
+            if (newIndex[v] == NoVertex) newIndex[v] = nextVertex++;
+            reordered[i * 3 + c] = newIndex[v];
+        }
+    }
+    for (uint32_t& v : newIndex) {
+        if (v == NoVertex) v = nextVertex++;
+    }
+
+    remapStream(model.vertices, newIndex);
+    remapStream(model.normals, newIndex);
+    remapStream(model.uvs, newIndex);
+    remapStream(model.tangents, newIndex);
+    remapStream(model.bitangents, newIndex);
+    model.indices = std::move(reordered);
+    stats.acmrAfter = computeACMR(std::as_const(model.indices).data(), numTriangles * 3, numVertices, cacheSize);
+    return stats;
+}
+
+void buildMeshlets(Model& model) {
+    const size_t numTriangles = model.numFaces();
+    std::vector<Model::Meshlet> meshlets;
+    std::vector<uint32_t> vertices;
+    std::vector<uint8_t> triangles;
+    vertices.reserve(model.numVertices() + model.numVertices() / 2);
+    triangles.reserve(numTriangles * 3);
+
+    // Local number of each model vertex in the open meshlet, 0xFF if not in it
+    std::vector<uint8_t> localIndex(model.numVertices(), 0xFF);
+    Model::Meshlet meshlet = {};
+    auto finish = [&]() {
+        if (meshlet.triangleCount == 0) return;
+        finishMeshlet(model, vertices, triangles, meshlet);
+        for (uint32_t i = 0; i < meshlet.vertexCount; ++i) localIndex[vertices[meshlet.vertexOffset + i]] = 0xFF;
+        meshlets.push_back(meshlet);
+        meshlet = {};
+        meshlet.vertexOffset = static_cast<uint32_t>(vertices.size());
+        meshlet.triangleOffset = static_cast<uint32_t>(triangles.size());
+    };
+
+    for (size_t t = 0; t < numTriangles; ++t) {
+        const uint32_t* triangle = model.getTriangle(t);
+        uint32_t newVertices = (localIndex[triangle[0]] == 0xFF) + (localIndex[triangle[1]] == 0xFF) + (localIndex[triangle[2]] == 0xFF);
+        if (meshlet.vertexCount + newVertices > Model::MaxMeshletVertices || meshlet.triangleCount == Model::MaxMeshletTriangles) finish();
+        for (int c = 0; c < 3; ++c) {
+            uint8_t& local = localIndex[triangle[c]];
+            if (local == 0xFF) {
+                local = static_cast<uint8_t>(meshlet.vertexCount++);
+                vertices.push_back(triangle[c]);
+            }
+            triangles.push_back(local);
+        }
+        meshlet.triangleCount++;
+    }
+    finish();
+
+    model.meshlets = std::move(meshlets);
+    model.meshletVertices = std::move(vertices);
+    model.meshletTriangles = std::move(triangles);
+}
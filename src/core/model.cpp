@@ -1,72 +1,52 @@
 // src/core/model.cpp
 #include "core/model.h"
 #include "core/framebuffer.h"
+#include "core/threadpool.h"
+#include <cfloat>
+#include <cmath>
+#include <functional>
 #include <fstream>
 #include <sstream>
 #include <string>
 #include <algorithm>
 
 
-const vec3f& Model::getVertex(int index) const {
-    // Add bounds checking if needed
-    return vertices[index];
-}
-const vec3f& Model::getNormal(int index) const {
-    if (index >= 0 && index < normals.size()) {
-        return normals[index];
-    }
-    static const Vector3<float> default_normal = {0.0f, 1.0f, 0.0f};
-    std::cerr << "Warning: Normal index out of bounds or invalid." << std::endl;
-    return default_normal;
-}
-const vec2f& Model::getUV(int index) const {
-    if (index >= 0 && index < uvs.size()) {
-        return uvs[index];
-    }
-    static const vec2f default_uv = {0.0f, 0.0f};
-    std::cerr << "Warning: UV index out of bounds or invalid." << std::endl;
-    return default_uv;
-}
-const vec3f& Model::getTangent(int index) const {
-    if (index >= 0 && index < tangents.size()) {
-        return tangents[index];
-    }
-    static const vec3f default_tangent = {1.0f, 0.0f, 0.0f};
-    std::cerr << "Warning: Tangent index out of bounds or invalid." << std::endl;
-    return default_tangent;
-}
+namespace { // Anonymous namespace for internal linkage helper functions
 
-const vec3f& Model::getBitangent(int index) const {
-     if (index >= 0 && index < bitangents.size()) {
-        return bitangents[index];
-    }
-    static const vec3f default_bitangent = {0.0f, 0.0f, 1.0f};
-    std::cerr << "Warning: Bitangent index out of bounds or invalid." << std::endl;
-    return default_bitangent;
-}
-const Model::Face& Model::getFace(int index) const {
-    return faces[index];
-}
+    constexpr uint32_t NoVertex = ~0u;
 
+    // Area weighted normal of every position (the cross product's length is twice the area)
+    std::vector<vec3f> smoothNormals(const MeshArray<vec3f>& positions, const MeshArray<Model::Face>& faces) {
+        std::vector<vec3f> normals(positions.size(), vec3f(0.0f, 0.0f, 0.0f));
+        for (const Model::Face& face : faces) {
+            const vec3f& v0 = positions[face.vertIndex[0]];
+            vec3f faceNormal = (positions[face.vertIndex[1]] - v0).cross(positions[face.vertIndex[2]] - v0);
+            for (int c = 0; c < 3; ++c) normals[face.vertIndex[c]] += faceNormal;
+        }
+        for (vec3f& n : normals) {
+            n = n.lengthSq() > 0.0f ? n.normalized() : vec3f(0.0f, 1.0f, 0.0f);
+        }
+        return normals;
+    }
 
-// --- Tangent Calculation ---
-// Basic implementation - assumes valid UVs and non-degenerate triangles
-// More robust implementations exist (e.g., using MikkTSpace)
-void Model::calculateTangents() {
-    tangents.assign(numVertices(), vec3f(0.0f, 0.0f, 0.0f));
-    bitangents.assign(numVertices(), vec3f(0.0f, 0.0f, 0.0f));
+    constexpr int TangentGrain = 4096; // Triangles or vertices per parallel task
 
-    for (size_t i = 0; i < numFaces(); ++i) {
-        const Face& face = getFace((int)i);
+    // Runs body(begin, end) over [0, count), split across the pool if there is one
+    void parallelRange(ThreadPool* pool, size_t count, int grain, const std::function<void(size_t, size_t)>& body) {
+        if (!pool || count <= static_cast<size_t>(grain)) {
+            body(0, count);
+            return;
+        }
+        pool->parallelFor(static_cast<int>(count), grain, [&body](int begin, int end) { body(begin, end); });
+    }
 
-        // Get vertices and UVs for the face
-        const vec3f& v0 = getVertex(face.vertIndex[0]);
-        const vec3f& v1 = getVertex(face.vertIndex[1]);
-        const vec3f& v2 = getVertex(face.vertIndex[2]);
-        const vec2f& uv0 = getUV(face.uvIndex[0]);
-        const vec2f& uv1 = getUV(face.uvIndex[1]);
-        const vec2f& uv2 = getUV(face.uvIndex[2]);
+    struct TriangleTangents {
+        vec3f tangent;   // Position gradient along u
+        vec3f bitangent; // Position gradient along v
+    };
 
+    TriangleTangents triangleGradients(const vec3f& v0, const vec3f& v1, const vec3f& v2,
+                                       const vec2f& uv0, const vec2f& uv1, const vec2f& uv2) {
         // Edges of the triangle & delta UVs
         vec3f edge1 = v1 - v0;
         vec3f edge2 = v2 - v0;
@@ -79,29 +59,125 @@ void Model::calculateTangents() {
             f = 0.0f; // Avoid issues, tangent/bitangent will be zero
         }
 
-        vec3f tangent;
-        tangent.x = f * (deltaUV2.y * edge1.x - deltaUV1.y * edge2.x);
-        tangent.y = f * (deltaUV2.y * edge1.y - deltaUV1.y * edge2.y);
-        tangent.z = f * (deltaUV2.y * edge1.z - deltaUV1.y * edge2.z);
+        TriangleTangents result;
+        result.tangent = (edge1 * deltaUV2.y - edge2 * deltaUV1.y) * f;
+        result.bitangent = (edge2 * deltaUV1.x - edge1 * deltaUV2.x) * f;
+        return result;
+    }
+
+    // Sign of the triangle's UV area (negative if mirrored), 0 if it has none
+    inline int uvOrientation(const vec2f& uv0, const vec2f& uv1, const vec2f& uv2) {
+        float signedArea = (uv1.x - uv0.x) * (uv2.y - uv0.y) - (uv1.y - uv0.y) * (uv2.x - uv0.x);
+        return std::abs(signedArea) > FLT_MIN ? (signedArea > 0.0f ? 1 : -1) : 0;
+    }
+
+    inline vec3f normalizedOrZero(const vec3f& v) {
+        float lengthSq = v.lengthSq();
+        return lengthSq > 0.0f ? v * (1.0f / std::sqrt(lengthSq)) : v;
+    }
+
+    inline vec3f projectToPlane(const vec3f& v, const vec3f& n) {
+        return normalizedOrZero(v - n * n.dot(v));
+    }
+
+    template <typename T>
+    void appendCopies(MeshArray<T>& stream, const std::vector<uint32_t>& sources) {
+        if (stream.empty()) return;
+        std::vector<T> extended(stream.begin(), stream.end());
+        for (uint32_t source : sources) extended.push_back(extended[source]);
+        stream = std::move(extended);
+    }
+
+    // Gives triangles with a mirrored UV mapping their own copy of every vertex
+    // they share with unmirrored ones. Returns the number of copies; afterwards
+    // `vertexOrientation` holds the UV orientation of each vertex's triangles.
+    size_t splitMirroredVertices(Model& model, ThreadPool* pool, std::vector<int8_t>& vertexOrientation) {
+        const size_t numTriangles = model.numFaces();
+        std::vector<int8_t> triangleOrientation(numTriangles);
+        parallelRange(pool, numTriangles, TangentGrain, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                const uint32_t* triangle = model.getTriangle(i);
+                triangleOrientation[i] = static_cast<int8_t>(uvOrientation(model.getUV(triangle[0]), model.getUV(triangle[1]), model.getUV(triangle[2])));
+            }
+        });
+
+        std::vector<uint8_t> orientations(model.numVertices(), 0); // Bit 0: preserving, bit 1: mirrored
+        for (size_t i = 0; i < numTriangles; ++i) {
+            if (triangleOrientation[i] == 0) continue; // No UV area, joins any side
+            const uint32_t* triangle = model.getTriangle(i);
+            for (int c = 0; c < 3; ++c) orientations[triangle[c]] |= triangleOrientation[i] > 0 ? 1 : 2;
+        }
+        std::vector<uint32_t> mirrorCopy(model.numVertices(), NoVertex);
+        std::vector<uint32_t> sources;
+        vertexOrientation.resize(model.numVertices());
+        for (size_t v = 0; v < orientations.size(); ++v) {
+            vertexOrientation[v] = orientations[v] & 2 ? -1 : 1;
+            if (orientations[v] == 3) {
+                vertexOrientation[v] = 1;
+                mirrorCopy[v] = static_cast<uint32_t>(model.numVertices() + sources.size());
+                sources.push_back(static_cast<uint32_t>(v));
+            }
+        }
+        if (sources.empty()) return 0;
+
+        appendCopies(model.vertices, sources);
+        appendCopies(model.normals, sources);
+        appendCopies(model.uvs, sources);
+        vertexOrientation.resize(model.numVertices(), -1);
+        uint32_t* indices = model.indices.data(); // Copies mapped (glTF) indices first
+        for (size_t i = 0; i < numTriangles; ++i) {
+            if (triangleOrientation[i] >= 0) continue;
+            uint32_t* triangle = indices + i * 3;
+            for (int c = 0; c < 3; ++c) {
+                if (mirrorCopy[triangle[c]] != NoVertex) triangle[c] = mirrorCopy[triangle[c]];
+            }
+        }
+        return sources.size();
+    }
+
+    // Adds the contributions of triangles [begin, end) to the vertices' sums;
+    // tangents/bitangents point at the entry of vertex `firstVertex`
+    void accumulateTangents(const Model& model, Model::TangentMode mode, size_t begin, size_t end, uint32_t firstVertex,
+                            vec3f* tangents, vec3f* bitangents) {
+        for (size_t i = begin; i < end; ++i) {
+            const uint32_t* triangle = model.getTriangle(i);
+            const vec3f* p[3] = {&model.getVertex(triangle[0]), &model.getVertex(triangle[1]), &model.getVertex(triangle[2])};
+            const vec2f& uv0 = model.getUV(triangle[0]);
+            const vec2f& uv1 = model.getUV(triangle[1]);
+            const vec2f& uv2 = model.getUV(triangle[2]);
+            TriangleTangents gradients = triangleGradients(*p[0], *p[1], *p[2], uv0, uv1, uv2);
 
-        vec3f bitangent;
-        bitangent.x = f * (-deltaUV2.x * edge1.x + deltaUV1.x * edge2.x);
-        bitangent.y = f * (-deltaUV2.x * edge1.y + deltaUV1.x * edge2.y);
-        bitangent.z = f * (-deltaUV2.x * edge1.z + deltaUV1.x * edge2.z);
+            if (mode == Model::TangentMode::Accumulate) {
+                // Area weighted: the gradients are not normalized
+                for (int j = 0; j < 3; ++j) {
+                    tangents[triangle[j] - firstVertex] += gradients.tangent;
+                    bitangents[triangle[j] - firstVertex] += gradients.bitangent;
+                }
+                continue;
+            }
 
-        // Accumulate tangents and bitangents for each vertex of the face
-        for (int j = 0; j < 3; ++j) {
-            tangents[face.vertIndex[j]] += tangent;
-            bitangents[face.vertIndex[j]] += bitangent;
+            // MikkTSpace: the u gradient's direction in the normal's plane,
+            // weighted by the triangle's angle at the vertex (in that plane).
+            // Triangles without UV area do not contribute.
+            if (uvOrientation(uv0, uv1, uv2) == 0) continue;
+            for (int c = 0; c < 3; ++c) {
+                vec3f n = normalizedOrZero(model.getNormal(triangle[c]));
+                vec3f toPrevious = projectToPlane(normalizedOrZero(*p[(c + 2) % 3] - *p[c]), n);
+                vec3f toNext = projectToPlane(normalizedOrZero(*p[(c + 1) % 3] - *p[c]), n);
+                float angle = std::acos(std::clamp(toPrevious.dot(toNext), -1.0f, 1.0f));
+                tangents[triangle[c] - firstVertex] += projectToPlane(gradients.tangent, n) * angle;
+            }
         }
     }
 
-    // Orthogonalize and normalize tangents/bitangents for each vertex
-    for (size_t i = 0; i < numVertices(); ++i) {
-        const vec3f& n = getNormal((int)i);
-        vec3f& t = tangents[i];
-        vec3f& b = bitangents[i];
+    // Basis for vertices without a usable tangent (no UV area, not used by any face)
+    void arbitraryTangents(const vec3f& n, vec3f& t, vec3f& b) {
+        vec3f up = (std::abs(n.y) < 0.99f) ? vec3f(0.0f, 1.0f, 0.0f) : vec3f(1.0f, 0.0f, 0.0f);
+        t = n.cross(up).normalized();
+        b = n.cross(t).normalized();
+    }
 
+    void orthonormalizeTangents(const vec3f& n, vec3f& t, vec3f& b) {
         if (t.lengthSq() > 0 && n.lengthSq() > 0) {
             // Gram-Schmidt orthogonalize: t = normalize(t - n * dot(n, t))
             t = (t - n * n.dot(t)).normalized();
@@ -115,17 +191,205 @@ void Model::calculateTangents() {
         } else {
             // If tangent is zero or normal is invalid, create an arbitrary basis
             // This might happen for vertices not used in any face or with bad data
-            vec3f up = (std::abs(n.y) < 0.99f) ? vec3f(0.0f, 1.0f, 0.0f) : vec3f(1.0f, 0.0f, 0.0f);
-            t = n.cross(up).normalized();
-            b = n.cross(t).normalized();
+            arbitraryTangents(n, t, b);
         }
 
-
         // Fallback if normalization failed (e.g., zero vectors)
         if (std::isnan(t.x) || std::isinf(t.x)) t = vec3f(1,0,0);
         if (std::isnan(b.x) || std::isinf(b.x)) b = vec3f(0,0,1);
+    }
+
+    // MikkTSpace output: the normalized sum, and bitangent = sign * cross(n, t)
+    void finishMikkTangents(const vec3f& normal, int orientation, vec3f& t, vec3f& b) {
+        vec3f n = normalizedOrZero(normal);
+        if (t.lengthSq() > 0.0f && n.lengthSq() > 0.0f) {
+            t = t.normalized();
+            b = n.cross(t) * static_cast<float>(orientation);
+        } else {
+            arbitraryTangents(n, t, b);
+        }
+        if (std::isnan(t.x) || std::isinf(t.x)) t = vec3f(1,0,0);
+        if (std::isnan(b.x) || std::isinf(b.x)) b = vec3f(0,0,1);
+    }
+
+} // end anonymous namespace
+
+void Model::weldVertices() {
+    const size_t numPositions = vertices.size();
+    const size_t numCorners = faces.size() * 3;
+
+    bool missingNormals = false;
+    for (const Face& face : faces) missingNormals |= face.normIndex[0] < 0 || face.normIndex[1] < 0 || face.normIndex[2] < 0;
+    std::vector<vec3f> generatedNormals;
+    if (missingNormals) generatedNormals = smoothNormals(vertices, faces);
+
+    // Vertices created for the same position are chained, so a corner only
+    // compares against the (usually one or two) vertices already at its position
+    std::vector<uint32_t> firstAtPosition(numPositions, NoVertex);
+    std::vector<uint32_t> nextAtPosition;
+    std::vector<int> sourcePosition, sourceUV, sourceNormal;
+    nextAtPosition.reserve(numPositions);
+    sourcePosition.reserve(numPositions);
+    sourceUV.reserve(numPositions);
+    sourceNormal.reserve(numPositions);
+
+    std::vector<uint32_t> weldedIndices(numCorners);
+    for (size_t f = 0; f < faces.size(); ++f) {
+        const Face& face = faces[f];
+        for (int c = 0; c < 3; ++c) {
+            int position = face.vertIndex[c], uv = face.uvIndex[c], normal = face.normIndex[c];
+            uint32_t vertex = firstAtPosition[position];
+            while (vertex != NoVertex && (sourceUV[vertex] != uv || sourceNormal[vertex] != normal)) vertex = nextAtPosition[vertex];
+            if (vertex == NoVertex) {
+                vertex = static_cast<uint32_t>(sourcePosition.size());
+                sourcePosition.push_back(position);
+                sourceUV.push_back(uv);
+                sourceNormal.push_back(normal);
+                nextAtPosition.push_back(firstAtPosition[position]);
+                firstAtPosition[position] = vertex;
+            }
+            weldedIndices[f * 3 + c] = vertex;
+        }
+    }
+
+    // Gather the streams in order of first use
+    const size_t numWelded = sourcePosition.size();
+    std::vector<vec3f> weldedPositions(numWelded), weldedNormals(numWelded);
+    std::vector<vec2f> weldedUVs(numWelded);
+    for (size_t i = 0; i < numWelded; ++i) {
+        weldedPositions[i] = vertices[sourcePosition[i]];
+        weldedNormals[i] = sourceNormal[i] >= 0 ? normals[sourceNormal[i]] : generatedNormals[sourcePosition[i]];
+        weldedUVs[i] = sourceUV[i] >= 0 ? uvs[sourceUV[i]] : vec2f(0.0f, 0.0f);
+    }
+    vertices = std::move(weldedPositions);
+    normals = std::move(weldedNormals);
+    uvs = std::move(weldedUVs);
+    indices = std::move(weldedIndices);
+    tangents.clear();
+    bitangents.clear();
+    faces.clear();
+}
+
+void Model::calculateBounds() {
+    if (vertices.empty()) {
+        boundsMin = boundsMax = vec3f(0.0f, 0.0f, 0.0f);
+        boundsRadius = 0.0f;
+        return;
+    }
+    boundsMin = boundsMax = getVertex(0);
+    for (const vec3f& v : vertices) {
+        boundsMin = vec3f(std::min(boundsMin.x, v.x), std::min(boundsMin.y, v.y), std::min(boundsMin.z, v.z));
+        boundsMax = vec3f(std::max(boundsMax.x, v.x), std::max(boundsMax.y, v.y), std::max(boundsMax.z, v.z));
+    }
+    // Tighter than the box's half diagonal unless the vertices reach its corners
+    vec3f center = getBoundsCenter();
+    float radiusSq = 0.0f;
+    for (const vec3f& v : vertices) radiusSq = std::max(radiusSq, (v - center).lengthSq());
+    boundsRadius = std::sqrt(radiusSq);
+}
+
+size_t Model::getMemoryUsage() const {
+    auto bytes = [](const auto& array) { return array.size() * sizeof(*array.data()); };
+    return bytes(vertices) + bytes(normals) + bytes(uvs) + bytes(tangents) + bytes(bitangents) + bytes(indices) +
+           bytes(quantizedVertices) + bytes(meshlets) + bytes(meshletVertices) + bytes(meshletTriangles) + bytes(faces);
+}
 
+void Model::quantizeVertices() {
+    std::vector<QuantizedVertex> packed(numVertices());
+    for (size_t i = 0; i < packed.size(); ++i) {
+        uint32_t v = static_cast<uint32_t>(i);
+        packed[i] = quantizeVertex(getVertex(v), getNormal(v), getUV(v), getTangent(v), getBitangent(v), boundsMin, boundsMax);
     }
+    // Rounding moves a position by up to half a step per axis: keep the bounding spheres conservative
+    float maxError = std::sqrt(quantizationStep(boundsMin, boundsMax).lengthSq()) * 0.5f;
+    boundsRadius += maxError;
+    if (!meshlets.empty() && !meshlets.isMapped()) {
+        for (size_t m = 0; m < meshlets.size(); ++m) meshlets[m].radius += maxError;
+    }
+    quantizedVertices = std::move(packed);
+    vertices.clear();
+    normals.clear();
+    uvs.clear();
+    tangents.clear();
+    bitangents.clear();
+}
+
+// --- Tangent Calculation ---
+// Triangles are split into one contiguous range per thread. The first range
+// scatters into the tangent streams; the others scatter into private buffers
+// that only span the vertices they touch. Welding numbers vertices by first
+// use, so those spans are short. A parallel pass over vertices then adds the
+// buffers in range order, giving the same sums as a serial scatter without
+// atomics, and orthonormalizes. Meshes without that locality, where the
+// buffers would outgrow the model, use a serial scatter instead.
+void Model::calculateTangents(TangentMode mode, ThreadPool* pool) {
+    const size_t numTriangles = numFaces();
+
+    // MikkTSpace never averages across a UV mirror seam: vertices shared by
+    // triangles of both orientations are split first
+    std::vector<int8_t> vertexOrientation;
+    size_t splitVertices = mode == TangentMode::MikkTSpace ? splitMirroredVertices(*this, pool, vertexOrientation) : 0;
+
+    tangents.assign(numVertices(), vec3f(0.0f, 0.0f, 0.0f));
+    bitangents.assign(numVertices(), vec3f(0.0f, 0.0f, 0.0f));
+
+    // Vertex span of each triangle range
+    size_t numRanges = pool && numTriangles >= 2 * static_cast<size_t>(TangentGrain) ? static_cast<size_t>(pool->getNumThreads()) : 1;
+    std::vector<uint32_t> spanFirst(numRanges, 0), spanLast(numRanges, 0);
+    auto rangeBegin = [&](size_t range) { return numTriangles * range / numRanges; };
+    if (numRanges > 1) {
+        pool->parallelFor(static_cast<int>(numRanges), 1, [&](int begin, int end) {
+            for (int range = begin; range < end; ++range) {
+                const uint32_t* first = indices.data() + rangeBegin(range) * 3;
+                const uint32_t* last = indices.data() + rangeBegin(range + 1) * 3;
+                auto [lo, hi] = std::minmax_element(first, last);
+                spanFirst[range] = first != last ? *lo : 0;
+                spanLast[range] = first != last ? *hi + 1 : 0;
+            }
+        });
+        size_t bufferedVertices = 0;
+        for (size_t range = 1; range < numRanges; ++range) bufferedVertices += spanLast[range] - spanFirst[range];
+        if (bufferedVertices > numVertices()) numRanges = 1;
+    }
+
+    // Scatter
+    std::vector<std::vector<vec3f>> rangeTangents(numRanges), rangeBitangents(numRanges);
+    auto scatterRange = [&](size_t range) {
+        if (range == 0) {
+            accumulateTangents(*this, mode, 0, rangeBegin(1), 0, tangents.data(), bitangents.data());
+            return;
+        }
+        size_t span = spanLast[range] - spanFirst[range];
+        rangeTangents[range].assign(span, vec3f(0.0f, 0.0f, 0.0f));
+        rangeBitangents[range].assign(span, vec3f(0.0f, 0.0f, 0.0f));
+        accumulateTangents(*this, mode, rangeBegin(range), rangeBegin(range + 1), spanFirst[range],
+                           rangeTangents[range].data(), rangeBitangents[range].data());
+    };
+    if (numRanges > 1) {
+        pool->parallelFor(static_cast<int>(numRanges), 1, [&](int begin, int end) {
+            for (int range = begin; range < end; ++range) scatterRange(range);
+        });
+    } else {
+        scatterRange(0);
+    }
+
+    // Reduce and orthonormalize
+    parallelRange(pool, numVertices(), TangentGrain, [&](size_t begin, size_t end) {
+        for (size_t range = 1; range < numRanges; ++range) {
+            size_t first = std::max<size_t>(begin, spanFirst[range]), last = std::min<size_t>(end, spanLast[range]);
+            for (size_t v = first; v < last; ++v) {
+                tangents[v] += rangeTangents[range][v - spanFirst[range]];
+                bitangents[v] += rangeBitangents[range][v - spanFirst[range]];
+            }
+        }
+        for (size_t v = begin; v < end; ++v) {
+            const vec3f& n = getNormal(static_cast<uint32_t>(v));
+            if (mode == TangentMode::MikkTSpace) finishMikkTangents(n, vertexOrientation[v], tangents[v], bitangents[v]);
+            else orthonormalizeTangents(n, tangents[v], bitangents[v]);
+        }
+    });
 
-    std::cout << "Calculated tangents and bitangents for " << numVertices() << " vertices." << std::endl;
+    std::cout << "Calculated tangents and bitangents for " << numVertices() << " vertices";
+    if (mode == TangentMode::MikkTSpace) std::cout << " (MikkTSpace, " << splitVertices << " split at mirror seams)";
+    std::cout << "." << std::endl;
 }
\ No newline at end of file
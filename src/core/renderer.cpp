@@ -1,11 +1,14 @@
 // src/core/renderer.cpp
 #include "core/renderer.h"
 #include "core/camera.h"
+#include "core/frustum.h"
 #include "core/threadpool.h"
+#include <limits>
 
 Renderer::Renderer(Framebuffer& fb, ThreadPool& tp)
     : framebuffer(fb),
-      threadPool(tp) {
+      threadPool(tp),
+      frameArenas(tp) {
     std::cout << "Renderer::Renderer" << std::endl;
 }
 
@@ -24,6 +27,20 @@ void Renderer::setCameraParams(const mat4& view, const mat4& projection, const v
 void Renderer::clear(const vec3f& color) {
     framebuffer.clear(color);
     framebuffer.clearZBuffer();
+    // Start of a new frame: all transient allocations of the last one are dead
+    frameArenas.reset();
+    depthPyramid.clear();
+    depthChanged = false;
+    for (std::atomic<size_t>& counter : meshletCounters) counter = 0;
+}
+
+MeshletStats Renderer::getMeshletStats() const {
+    MeshletStats stats;
+    stats.total = meshletCounters[0];
+    stats.frustumCulled = meshletCounters[1];
+    stats.backfaceCulled = meshletCounters[2];
+    stats.occlusionCulled = meshletCounters[3];
+    return stats;
 }
 
 // Interpolate the whole Varyings struct perspective-correctly
@@ -75,6 +92,7 @@ void Renderer::setupShaderUniforms(Shader& shader, const DrawCommand& command) {
 
         shader.uniform_NormalTexture = mat->normalTexture;
         shader.uniform_UseNormalMap = (mat->normalTexture && !mat->normalTexture->empty());
+        shader.uniform_NormalMapTwoChannel = shader.uniform_UseNormalMap && isTwoChannelNormal(mat->normalTexture->getFormat());
 
         shader.uniform_AoTexture = mat->aoTexture;
         shader.uniform_UseAoMap = (mat->aoTexture && !mat->aoTexture->empty());
@@ -84,6 +102,12 @@ void Renderer::setupShaderUniforms(Shader& shader, const DrawCommand& command) {
 
         shader.uniform_GlossTexture = mat->glossTexture;
         shader.uniform_UseGlossMap = (mat->glossTexture && !mat->glossTexture->empty());
+
+        bool usePacked = mat->packedScalarTexture && !mat->packedScalarTexture->empty();
+        shader.uniform_PackedScalarTexture = mat->packedScalarTexture;
+        shader.uniform_UsePackedSpecular = usePacked && mat->packedSpecular;
+        shader.uniform_UsePackedGloss = usePacked && mat->packedGloss;
+        shader.uniform_UsePackedAo = usePacked && mat->packedAo;
     } else {
         // Handle case where material is null? Set defaults? Error?
         std::cerr << "Warning: Material pointer is null in DrawCommand." << std::endl;
@@ -105,6 +129,13 @@ void Renderer::submit(const DrawCommand& command) {
     // Set up all shader uniforms based on current renderer state and the command
     setupShaderUniforms(shader, command);
 
+    // Clustered models are culled and drawn meshlet by meshlet
+    if (!model.meshlets.empty()) {
+        submitMeshlets(model, material, shader, command.modelMatrix);
+        depthChanged = true;
+        return;
+    }
+
     // --- Face Processing Loop ---
     int numFaces = static_cast<int>(model.numFaces());
     if (numFaces <= 0) return; // Nothing to draw
@@ -135,9 +166,143 @@ void Renderer::submit(const DrawCommand& command) {
     for (int i = 0; i < numFaces; ++i) {
         processFace(model, material, shader, i);
     }
+#endif
+    depthChanged = true;
+}
+
+namespace { // Anonymous namespace for internal linkage helper functions
+
+    // One index into the welded streams fetches the whole vertex; quantized
+    // models are decoded here, so shaders always see float attributes
+    inline VertexInput fetchVertex(const Model& model, uint32_t vertex) {
+        VertexInput input;
+        if (model.isQuantized()) {
+            dequantizeVertex(model.quantizedVertices[vertex], model.boundsMin, quantizationStep(model.boundsMin, model.boundsMax),
+                             input.position, input.normal, input.uv, input.tangent, input.bitangent);
+        } else {
+            input.position = model.getVertex(vertex);
+            input.normal = model.getNormal(vertex);
+            input.uv = model.getUV(vertex);
+            input.tangent = model.getTangent(vertex);
+            input.bitangent = model.getBitangent(vertex);
+        }
+        return input;
+    }
+
+    // Draws with fewer meshlets test against the last depth pyramid instead of rebuilding it
+    constexpr size_t MinMeshletsForDepthRebuild = 64;
+
+    // Every triangle faces away from the camera: the camera lies inside the
+    // cone's negative, widened by the bounding sphere (the test meshoptimizer uses)
+    bool meshletBackFacing(const Model::Meshlet& meshlet, const vec3f& cameraPosition) {
+        vec3f toCenter = meshlet.center - cameraPosition;
+        return toCenter.dot(meshlet.coneAxis) >= meshlet.coneCutoff * std::sqrt(toCenter.lengthSq()) + meshlet.radius;
+    }
+
+    // Screen rectangle and nearest depth of the sphere's bounding box; false if
+    // the box reaches behind the camera (then it cannot be occlusion tested)
+    bool projectSphereBounds(const mat4& mvp, const vec3f& center, float radius, int width, int height,
+                             float& minX, float& minY, float& maxX, float& maxY, float& nearestDepth) {
+        minX = minY = std::numeric_limits<float>::max();
+        maxX = maxY = -std::numeric_limits<float>::max();
+        nearestDepth = 1.0f;
+        for (int corner = 0; corner < 8; ++corner) {
+            vec4f p(center.x + ((corner & 1) ? radius : -radius), center.y + ((corner & 2) ? radius : -radius),
+                    center.z + ((corner & 4) ? radius : -radius), 1.0f);
+            vec4f clip = mvp * p;
+            if (clip.w <= 1e-5f) return false;
+            float invW = 1.0f / clip.w;
+            float x = (clip.x * invW + 1.0f) * 0.5f * width;
+            float y = (clip.y * invW + 1.0f) * 0.5f * height;
+            minX = std::min(minX, x);
+            maxX = std::max(maxX, x);
+            minY = std::min(minY, y);
+            maxY = std::max(maxY, y);
+            nearestDepth = std::min(nearestDepth, (clip.z * invW + 1.0f) * 0.5f);
+        }
+        return true;
+    }
+
+} // end anonymous namespace
+
+void Renderer::submitMeshlets(const Model& model, const Material& material, Shader& shader, const mat4& modelMatrix) {
+    const mat4& mvp = shader.uniform_MVP;
+    Frustum frustum(mvp); // Model space
+    // Backface tests are invariant under the model transform: do them in model space
+    vec4f camera = modelMatrix.inverse() * vec4f(currentCameraPosition, 1.0f);
+    vec3f cameraInModel = camera.xyz() * (1.0f / camera.w);
+
+    size_t numMeshlets = model.meshlets.size();
+    if (depthChanged && numMeshlets >= MinMeshletsForDepthRebuild) {
+        depthPyramid.build(framebuffer.getDepthBuffer(), framebuffer.getWidth(), framebuffer.getHeight(), &threadPool);
+        depthChanged = false;
+    }
+
+    // Cull first, then draw only the survivors: the draw chunks then carry
+    // even amounts of shading work however the culled meshlets cluster.
+    // Both lists live in the submitting thread's frame arena.
+    LinearArena& arena = frameArenas.local();
+    ArenaVector<uint8_t> visible(numMeshlets, 0, ArenaAllocator<uint8_t>(arena));
+    auto cull = [&](int begin, int end) {
+        size_t culled[3] = {0, 0, 0};
+        for (int i = begin; i < end; ++i) {
+            const Model::Meshlet& meshlet = model.meshlets[i];
+            if (frustum.sphereOutside(meshlet.center, meshlet.radius)) {
+                culled[0]++;
+                continue;
+            }
+            if (meshletBackFacing(meshlet, cameraInModel)) {
+                culled[1]++;
+                continue;
+            }
+            float minX, minY, maxX, maxY, nearestDepth;
+            if (!depthPyramid.empty() &&
+                projectSphereBounds(mvp, meshlet.center, meshlet.radius, framebuffer.getWidth(), framebuffer.getHeight(),
+                                    minX, minY, maxX, maxY, nearestDepth) &&
+                depthPyramid.isOccluded(minX, minY, maxX, maxY, nearestDepth)) {
+                culled[2]++;
+                continue;
+            }
+            visible[i] = 1;
+        }
+        for (int c = 0; c < 3; ++c) meshletCounters[c + 1] += culled[c];
+    };
+    meshletCounters[0] += numMeshlets;
+#ifdef MultiThreading
+    threadPool.parallelFor(static_cast<int>(numMeshlets), 64, cull);
+#else
+    cull(0, static_cast<int>(numMeshlets));
+#endif
+
+    ArenaVector<uint32_t> drawList{ArenaAllocator<uint32_t>(arena)};
+    drawList.reserve(numMeshlets);
+    for (size_t i = 0; i < numMeshlets; ++i) {
+        if (visible[i]) drawList.push_back(static_cast<uint32_t>(i));
+    }
+    auto draw = [&](int begin, int end) {
+        for (int i = begin; i < end; ++i) processMeshlet(model, material, shader, model.meshlets[drawList[i]]);
+    };
+#ifdef MultiThreading
+    threadPool.parallelFor(static_cast<int>(drawList.size()), 16, draw);
+#else
+    draw(0, static_cast<int>(drawList.size()));
 #endif
 }
 
+void Renderer::processMeshlet(const Model& model, const Material& material, Shader& shader, const Model::Meshlet& meshlet) {
+    // Every vertex is shaded exactly once per meshlet
+    Varyings varyings[Model::MaxMeshletVertices];
+    const uint32_t* vertices = model.meshletVertices.data() + meshlet.vertexOffset;
+    for (uint32_t i = 0; i < meshlet.vertexCount; ++i) {
+        varyings[i] = shader.vertex(fetchVertex(model, vertices[i]));
+    }
+
+    const uint8_t* corners = model.meshletTriangles.data() + meshlet.triangleOffset;
+    for (uint32_t t = 0; t < meshlet.triangleCount; ++t, corners += 3) {
+        processTriangle(varyings[corners[0]], varyings[corners[1]], varyings[corners[2]], material);
+    }
+}
+
 ScreenSpaceGradients calcSSGradients(const ScreenVertex v[3]) {
     ScreenSpaceGradients grads;
 
@@ -175,25 +340,26 @@ ScreenSpaceGradients calcSSGradients(const ScreenVertex v[3]) {
 
 
 void Renderer::processFace(const Model& model, const Material& material, Shader& shader, int faceIndex) {
-    Model::Face face = model.getFace(faceIndex);
-    ScreenVertex screenVertices[3];
+    const uint32_t* triangle = model.getTriangle(faceIndex);
     Varyings varyings[3];
-    bool triangleVisible = false;
 
     // Vertex processing
     for (int j = 0; j < 3; ++j) {
-        VertexInput vInput;
-        vInput.position = model.getVertex(face.vertIndex[j]);
-        vInput.normal = model.getNormal(face.normIndex[j]);
-        vInput.uv = model.getUV(face.uvIndex[j]);
-        vInput.tangent = model.getTangent(face.vertIndex[j]);
-        vInput.bitangent = model.getBitangent(face.vertIndex[j]);
+        varyings[j] = shader.vertex(fetchVertex(model, triangle[j]));
+    }
 
-        varyings[j] = material.shader->vertex(vInput);
+    processTriangle(varyings[0], varyings[1], varyings[2], material);
+}
 
+void Renderer::processTriangle(const Varyings& v0, const Varyings& v1, const Varyings& v2, const Material& material) {
+    const Varyings* varyings[3] = {&v0, &v1, &v2};
+    ScreenVertex screenVertices[3];
+    bool triangleVisible = false;
+
+    for (int j = 0; j < 3; ++j) {
         // Check if vertex is in front of near plane and valid
-        float w = varyings[j].clipPosition.w;
-        float z = varyings[j].clipPosition.z;
+        float w = varyings[j]->clipPosition.w;
+        float z = varyings[j]->clipPosition.z;
         if (w > 0 && z >= 0) {
             triangleVisible = true;
         }
@@ -203,20 +369,20 @@ void Renderer::processFace(const Model& model, const Material& material, Shader&
 
     // Perspective division and viewport transform
     for (int j = 0; j < 3; ++j) {
-        float w = varyings[j].clipPosition.w;
+        float w = varyings[j]->clipPosition.w;
         if (w <= 0) continue;  // Skip invalid vertices
         float invW = 1.0f / w;
         vec3f ndcPos = {
-            varyings[j].clipPosition.x * invW,
-            varyings[j].clipPosition.y * invW,
-            varyings[j].clipPosition.z * invW
+            varyings[j]->clipPosition.x * invW,
+            varyings[j]->clipPosition.y * invW,
+            varyings[j]->clipPosition.z * invW
         };
 
         screenVertices[j].x = static_cast<int>((ndcPos.x + 1.0f) * 0.5f * framebuffer.getWidth());
         screenVertices[j].y = static_cast<int>((ndcPos.y + 1.0f) * 0.5f * framebuffer.getHeight());
         screenVertices[j].z = (ndcPos.z + 1.0f) * 0.5f;
         screenVertices[j].invW = invW;
-        screenVertices[j].varyings = varyings[j];
+        screenVertices[j].varyings = *varyings[j];
     }
 
     // Backface culling
@@ -2,21 +2,189 @@
 #include "core/resource_manager.h"
 #include "core/texture/tga_texture.h"
 #include "core/texture/dds_texture.h"
+#include "core/texture/packed_texture.h"
+#include "core/texture/texture_cache_file.h"
+#include "core/texture/solid_texture.h"
 #include "core/model.h"
+#include "core/mesh_cache_file.h"
+#include "core/mesh_optimizer.h"
 #include "core/blinn_phong_shader.h"
+#include "core/material.h"
+#include "core/threadpool.h"
+#include "io/obj_reader.h"
+#include "io/gltf_reader.h"
 
 #include <iostream>
 #include <fstream>
-#include <sstream>
+#include <filesystem>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <utility>
+
+#ifdef _WIN32
+#include <process.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace { // Anonymous namespace for internal linkage helper functions
+
+    // Exporters usually optimize the vertex order already (an ACMR around 0.6 to
+    // 0.7 for the modelled FIFO); above this the order is redone
+    constexpr float PreorderedMaxACMR = 0.8f;
+
+    // Bytes of a glTF asset's models (its textures are cached on their own)
+    size_t gltfBytes(const std::vector<ModelPart>& parts) {
+        std::vector<const Model*> models;
+        size_t bytes = 0;
+        for (const ModelPart& part : parts) {
+            if (std::find(models.begin(), models.end(), part.model.get()) != models.end()) continue;
+            models.push_back(part.model.get());
+            bytes += part.model->getMemoryUsage();
+        }
+        return bytes;
+    }
+
+    // Held by nothing but its cache entry
+    template <typename T>
+    bool isIdle(const std::shared_ptr<T>& resource) {
+        return resource.use_count() <= 1;
+    }
+
+    bool isIdle(const std::vector<ModelPart>& parts) {
+        // Parts share models and materials, so compare against the references of the list itself
+        std::map<const void*, long> references;
+        for (const ModelPart& part : parts) {
+            references[part.model.get()]++;
+            references[part.material.get()]++;
+        }
+        for (const ModelPart& part : parts) {
+            if (part.model.use_count() > references[part.model.get()]) return false;
+            if (part.material && part.material.use_count() > references[part.material.get()]) return false;
+        }
+        return true;
+    }
+
+    struct EvictionCandidate {
+        uint32_t lastUsedFrame;
+        size_t bytes;
+        int cache; // Index into the key lists of evictIdle
+        std::string key;
+    };
+
+    // Marks the entries still referenced elsewhere as used in `frame` and lists the idle ones
+    template <typename T>
+    void collectIdle(const ResourceCache<T>& cache, int cacheIndex, uint32_t frame, std::vector<EvictionCandidate>& candidates) {
+        auto snapshot = cache.snapshot(); // Kept alive while iterating: inserts publish new maps
+        for (const auto& [key, entry] : *snapshot) {
+            if (isIdle(entry->resource)) {
+                candidates.push_back({entry->lastUsedFrame.load(std::memory_order_relaxed), entry->bytes, cacheIndex, key});
+            } else {
+                entry->lastUsedFrame.store(frame, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    template <typename T>
+    std::shared_future<T> readyFuture(T value) {
+        std::promise<T> promise;
+        promise.set_value(std::move(value));
+        return promise.get_future().share();
+    }
+
+    // Key of a packed texture and the options its sources load with
+    TextureLoadOptions packedSourceOptions(const TextureLoadOptions& options) {
+        TextureLoadOptions sourceOptions = options;
+        sourceOptions.usage = TextureUsage::Scalar;
+        sourceOptions.virtualTexture = false;
+        sourceOptions.compressOnLoad = false; // Packed from full precision channels
+        return sourceOptions;
+    }
+
+    // Page file of one virtual texture instance. Process id and a counter keep
+    // it unique: other processes, and reloads of an evicted texture in this
+    // one, must never rewrite or delete the pages of a live instance
+    std::filesystem::path virtualPageFile(const std::string& cacheKey) {
+        static std::atomic<uint64_t> counter{0};
+#ifdef _WIN32
+        int pid = _getpid();
+#else
+        int pid = static_cast<int>(getpid());
+#endif
+        return std::filesystem::temp_directory_path() /
+            ("softrasterizer_vt_" + std::to_string(pid) + "_" + std::to_string(counter++) + "_" +
+             std::to_string(std::hash<std::string>{}(cacheKey)) + ".pages");
+    }
+
+    std::string packedCacheKey(const std::string (&channelFiles)[3], const TextureLoadOptions& options) {
+        std::string cacheKey = "packed";
+        for (const auto& file : channelFiles) cacheKey += "|" + file;
+        return cacheKey + "|" + packedSourceOptions(options).cacheKey("");
+    }
+
+} // end anonymous namespace
 
 
 // --- Texture Loading ---
-std::shared_ptr<Texture> ResourceManager::loadTexture(const std::string& filename) {
-    // Check cache first
-    auto it = textureCache.find(filename);
-    if (it != textureCache.end()) {
+std::shared_ptr<Texture> ResourceManager::loadTexture(const std::string& filename, const TextureLoadOptions& options) {
+    // Check cache first (the same file may be cached once per set of load options)
+    std::string cacheKey = options.cacheKey(filename);
+    std::shared_ptr<Texture> cachedTexture;
+    if (textureCache.find(cacheKey, cachedTexture, getFrame())) {
         // std::cout << "Cache hit for texture: " << filename << std::endl;
-        return it->second;
+        return cachedTexture;
+    }
+
+    if (options.virtualTexture) {
+        // Decode the source once, then split it into pages and keep only the mip tail
+        TextureLoadOptions sourceOptions = options;
+        sourceOptions.virtualTexture = false;
+        sourceOptions.keepCompressed = false;
+        sourceOptions.compressOnLoad = false;
+        std::shared_ptr<Texture> source = loadSourceTexture(filename, sourceOptions); // Do not keep the full copy around
+        if (!source) return nullptr;
+
+        auto texture = VirtualTexture::create(*source, virtualPageFile(cacheKey).string(), virtualTextures);
+        if (!texture) {
+            std::cerr << "\033[31m Error: Failed to create virtual texture for: " << filename << "\033[0m " << std::endl;
+            return nullptr;
+        }
+        texture->options = options;
+        std::cout << "\033[32m Created virtual texture: " << filename << " (" << texture->getNumPages() << " pages over "
+            << texture->getNumPagedLevels() << " levels, " << texture->getMemoryUsage() / 1024 << " KB resident tail) \033[0m" << std::endl;
+        textureCache.insert(cacheKey, texture, texture->getMemoryUsage(), getFrame());
+        return texture;
+    }
+
+    std::shared_ptr<Texture> texture = readTexture(filename, options);
+    if (texture) textureCache.insert(cacheKey, texture, texture->getMemoryUsage(), getFrame()); // Add to cache on success
+    return texture;
+}
+
+std::shared_ptr<Texture> ResourceManager::loadSourceTexture(const std::string& filename, const TextureLoadOptions& options) {
+    std::shared_ptr<Texture> cachedTexture;
+    if (textureCache.find(options.cacheKey(filename), cachedTexture, getFrame())) {
+        return cachedTexture;
+    }
+    return readTexture(filename, options);
+}
+
+std::shared_ptr<Texture> ResourceManager::readTexture(const std::string& filename, const TextureLoadOptions& options) {
+    auto loadStart = std::chrono::high_resolution_clock::now();
+    auto elapsedMs = [&loadStart]() {
+        return std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - loadStart).count();
+    };
+
+    // Preprocessed copy: mapped as is, no decoding or mip generation
+    if (!textureCacheDirectory.empty()) {
+        if (auto cached = TextureCacheFile::load(textureCacheDirectory, filename, options)) {
+            std::cout << "\033[32m Mapped cached texture: " << filename << " (" << cached->getWidth() << "x" << cached->getHeight() << ", "
+                << texelFormatName(cached->getFormat()) << ", " << cached->getMemoryUsage() / 1024 << " KB, " << elapsedMs() << " ms) \033[0m" << std::endl;
+            return cached;
+        }
     }
 
     std::cout << "Loading texture: " << filename << std::endl;
@@ -35,10 +203,17 @@ std::shared_ptr<Texture> ResourceManager::loadTexture(const std::string& filenam
         return nullptr;
     }
 
+    if (texture) {
+        texture->options = options;
+        texture->workers = loadPool();
+    }
     if (texture && texture->load(filename)) {
         std::cout << "\033[32m Successfully loaded texture (MipLevel 0): " << filename \
-            << " (" << texture->mipLevels[0].width << "x" << texture->mipLevels[0].height << ") \033[0m" << std::endl;
-        textureCache[filename] = texture; // Add to cache on success
+            << " (" << texture->mipLevels[0].width << "x" << texture->mipLevels[0].height << ", "
+            << texelFormatName(texture->getFormat()) << ", " << texture->getMemoryUsage() / 1024 << " KB, " << elapsedMs() << " ms) \033[0m" << std::endl;
+        if (!textureCacheDirectory.empty() && !TextureCacheFile::store(textureCacheDirectory, filename, options, *texture)) {
+            std::cerr << "\033[31m Warning: Could not write texture cache file for: " << filename << "\033[0m " << std::endl;
+        }
         return texture;
     } else {
         std::cerr << "\033[31m Error: Failed to load texture data from file: " << filename << "\033[0m " << std::endl;
@@ -47,104 +222,129 @@ std::shared_ptr<Texture> ResourceManager::loadTexture(const std::string& filenam
 }
 
 
-// --- Model Loading ---
+std::shared_ptr<Texture> ResourceManager::loadPackedTexture(const std::string (&channelFiles)[3], const TextureLoadOptions& options) {
+    // Sources are loaded as plain scalar maps
+    TextureLoadOptions sourceOptions = packedSourceOptions(options);
+    std::string cacheKey = packedCacheKey(channelFiles, options);
+    std::shared_ptr<Texture> cachedTexture;
+    if (textureCache.find(cacheKey, cachedTexture, getFrame())) {
+        return cachedTexture;
+    }
 
-bool ResourceManager::loadObjFromFile(const std::string& filename, Model& model) {
-    model.vertices.clear();
-    model.normals.clear();
-    model.uvs.clear();
-    model.faces.clear();
-    model.tangents.clear();
-    model.bitangents.clear();
+    std::shared_ptr<Texture> sources[PackedTexture::MaxChannels];
+    const Texture* channels[PackedTexture::MaxChannels] = {};
+    for (int c = 0; c < PackedTexture::MaxChannels; ++c) {
+        if (channelFiles[c].empty()) continue;
+        sources[c] = loadSourceTexture(channelFiles[c], sourceOptions); // Only the packed copy stays around
+        channels[c] = sources[c].get();
+    }
 
-    std::ifstream file(filename);
-    if (!file.is_open()) {
-        return false;
+    auto texture = PackedTexture::create(channels, options.layout);
+    if (!texture) {
+        std::cerr << "\033[31m Error: No channel of the packed texture could be loaded: " << cacheKey << "\033[0m " << std::endl;
+        return nullptr;
     }
+    std::cout << "\033[32m Packed texture: " << cacheKey << " (" << texture->getWidth() << "x" << texture->getHeight() << ", "
+        << texture->getMemoryUsage() / 1024 << " KB) \033[0m" << std::endl;
+    textureCache.insert(cacheKey, texture, texture->getMemoryUsage(), getFrame());
+    return texture;
+}
 
-    std::vector<vec3f> temp_vertices;
-    std::vector<vec2f> temp_uvs;
-    std::vector<vec3f> temp_normals;
-    std::vector<Model::Face> temp_faces;
 
-    std::string line;
-    while (std::getline(file, line)) {
-        if (line.empty() || line[0] == '#') continue;
+// --- Model Loading ---
 
-        std::istringstream iss(line);
-        std::string type;
-        iss >> type;
+bool ResourceManager::loadObjFromFile(const std::string& filename, Model& model, const ModelLoadOptions& options) {
+    auto loadStart = std::chrono::high_resolution_clock::now();
+    if (!readObj(filename, model, loadPool())) {
+        return false;
+    }
+    double loadMs = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - loadStart).count();
+    std::error_code error;
+    double megabytes = std::filesystem::file_size(filename, error) / (1024.0 * 1024.0);
+
+    size_t positions = model.vertices.size(), normals = model.normals.size(), uvs = model.uvs.size();
+    std::cout << "\033[32m Successfully Loaded OBJ: " << filename << " (Positions: " << positions
+        << ", Normals: " << normals << ", UVs: " << uvs
+        << ", Faces: " << model.faces.size() << ", " << loadMs << " ms, "
+        << (error || loadMs <= 0.0 ? 0.0 : megabytes * 1000.0 / loadMs) << " MB/s) \033[0m" << std::endl;
+
+    auto weldStart = std::chrono::high_resolution_clock::now();
+    model.weldVertices();
+    double weldMs = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - weldStart).count();
+    std::cout << " Welded " << positions << " positions into " << model.numVertices() << " vertices (" << weldMs << " ms)" << std::endl;
+
+    model.calculateBounds();
+    prepareModel(model, options.tangentMode, options.quantize, false);
+    return true;
+}
 
-        if (type == "v") {
-            vec3f v;
-            iss >> v.x >> v.y >> v.z;
-            temp_vertices.push_back(std::move(v));
-        }
-        else if (type == "vt") {
-            vec2f vt;
-            iss >> vt.x >> vt.y;
-            temp_uvs.push_back(std::move(vt));
-        }
-        else if (type == "vn") {
-            vec3f vn;
-            iss >> vn.x >> vn.y >> vn.z;
-            temp_normals.push_back(std::move(vn));
-        }
-        else if (type == "f") {
-            Model::Face face;
-            char sep;
-            int v, t, n, i = 0;
-            
-            while (iss >> v) {
-                face.vertIndex[i] = --v;
-                
-                if (iss.peek() == '/') {
-                    iss >> sep;
-                    if (iss.peek() != '/') {
-                        iss >> t;
-                        face.uvIndex[i] = --t;
-                    }
-                    if (iss.peek() == '/') {
-                        iss >> sep >> n;
-                        face.normIndex[i] = --n;
-                    }
-                }
-                i++;
-            }
-            
-            temp_faces.push_back(std::move(face));
-        }
+void ResourceManager::prepareModel(Model& model, Model::TangentMode tangentMode, bool quantize, bool preordered) {
+    // Before reordering: MikkTSpace may split vertices
+    if (model.tangents.size() != model.numVertices() || model.bitangents.size() != model.numVertices()) {
+        auto tangentStart = std::chrono::high_resolution_clock::now();
+        model.calculateTangents(tangentMode, loadPool());
+        double tangentMs = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - tangentStart).count();
+        std::cout << " Tangents took " << tangentMs << " ms" << std::endl;
     }
 
-    file.close();
-    model.vertices = std::move(temp_vertices);
-    model.normals = std::move(temp_normals) ;
-    model.uvs = std::move(temp_uvs);
-    model.faces = std::move(temp_faces);
+    float acmr = preordered ? computeACMR(std::as_const(model.indices).data(), model.indices.size(), model.numVertices()) : 0.0f;
+    if (preordered && acmr <= PreorderedMaxACMR) {
+        std::cout << " Kept the file's vertex order (ACMR " << acmr << ")" << std::endl;
+    } else {
+        auto optimizeStart = std::chrono::high_resolution_clock::now();
+        MeshOptimizationStats stats = optimizeMesh(model);
+        double optimizeMs = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - optimizeStart).count();
+        std::cout << " Optimized " << model.numFaces() << " triangles into " << stats.numClusters << " clusters: ACMR "
+            << stats.acmrBefore << " -> " << stats.acmrAfter << " (" << VertexCacheSize << " entry FIFO model, " << optimizeMs << " ms)" << std::endl;
+    }
 
-    std::cout << "\033[32m Successfully Loaded OBJ: " << filename << " (Vertices: " << model.numVertices()
-        << ", Normals: " << model.numNormals() << ", UVs: " << model.numUVs()
-        << ", Faces: " << model.numFaces() << ") \033[0m" << std::endl;
+    buildMeshlets(model);
+    std::cout << " Built " << model.meshlets.size() << " meshlets (" << model.meshletVertices.size() << " meshlet vertices)" << std::endl;
 
-    model.calculateTangents();
-    return true;
+    if (quantize) {
+        size_t floatBytes = model.numVertices() * (4 * sizeof(vec3f) + sizeof(vec2f));
+        model.quantizeVertices();
+        size_t quantizedBytes = model.numVertices() * sizeof(QuantizedVertex);
+        std::cout << " Quantized " << model.numVertices() << " vertices: " << floatBytes / 1024 << " KB -> "
+            << quantizedBytes / 1024 << " KB" << std::endl;
+    }
 }
 
 std::shared_ptr<Model> ResourceManager::loadModel(const std::string& filename) {
+    return loadModel(filename, modelOptions, modelCacheDirectory);
+}
+
+std::shared_ptr<Model> ResourceManager::loadModel(const std::string& filename, const ModelLoadOptions& options, const std::string& cacheDirectory) {
     // Check cache
-    auto it = modelCache.find(filename);
-    if (it != modelCache.end()) {
+    std::string cacheKey = options.cacheKey(filename);
+    std::shared_ptr<Model> cachedModel;
+    if (modelCache.find(cacheKey, cachedModel, getFrame())) {
         // std::cout << "Cache hit for model: " << filename << std::endl;
-        return it->second;
+        return cachedModel;
     }
 
     std::cout << "Loading model: " << filename << std::endl;
 
+    // Binary copy: mapped as is, no parsing or tangent calculation
+    if (!cacheDirectory.empty()) {
+        auto loadStart = std::chrono::high_resolution_clock::now();
+        if (auto cached = MeshCacheFile::load(cacheDirectory, filename, options)) {
+            double loadMs = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - loadStart).count();
+            std::cout << "\033[32m Mapped cached model: " << filename << " (Vertices: " << cached->numVertices()
+                << ", Faces: " << cached->numFaces() << ", " << loadMs << " ms) \033[0m" << std::endl;
+            modelCache.insert(cacheKey, cached, cached->getMemoryUsage(), getFrame());
+            return cached;
+        }
+    }
+
     auto model = std::make_shared<Model>();
 
     // Use internal loader function
-    if (loadObjFromFile(filename, *model)) {
-        modelCache[filename] = model; // Add to cache on success
+    if (loadObjFromFile(filename, *model, options)) {
+        if (!cacheDirectory.empty() && !MeshCacheFile::store(cacheDirectory, filename, *model, options)) {
+            std::cerr << "\033[31m Warning: Could not write model cache file for: " << filename << "\033[0m " << std::endl;
+        }
+        modelCache.insert(cacheKey, model, model->getMemoryUsage(), getFrame()); // Add to cache on success
         return model;
     } else {
         std::cerr << "\033[31m Error: Failed to load model data from file: " << filename << "\033[0m" << std::endl;
@@ -153,24 +353,196 @@ std::shared_ptr<Model> ResourceManager::loadModel(const std::string& filename) {
     }
 }
 
+std::vector<ModelPart> ResourceManager::loadGltf(const std::string& filename, const TextureLoadOptions& textureOptions) {
+    return loadGltf(filename, textureOptions, modelOptions);
+}
+
+std::vector<ModelPart> ResourceManager::loadGltf(const std::string& filename, const TextureLoadOptions& textureOptions,
+                                                 const ModelLoadOptions& options) {
+    std::string cacheKey = options.cacheKey(filename) + "|" + textureOptions.cacheKey("");
+    std::vector<ModelPart> cachedParts;
+    if (gltfCache.find(cacheKey, cachedParts, getFrame())) {
+        return cachedParts;
+    }
+
+    std::cout << "Loading glTF asset: " << filename << std::endl;
+    auto loadStart = std::chrono::high_resolution_clock::now();
+    GltfAsset asset;
+    if (!readGltf(filename, asset)) {
+        std::cerr << "\033[31m Error: Failed to load glTF asset: " << filename << "\033[0m" << std::endl;
+        return {};
+    }
+    double loadMs = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - loadStart).count();
+    std::cout << "\033[32m Successfully Loaded glTF: " << filename << " (Primitives: " << asset.primitives.size()
+        << ", Materials: " << asset.materials.size() << ", " << loadMs << " ms) \033[0m" << std::endl;
+
+    // Models shared by several nodes are prepared once. glTF asks for MikkTSpace
+    // when tangents are missing, and its index buffers are already vertex order.
+    std::vector<std::shared_ptr<Material>> materials(asset.materials.size());
+    std::shared_ptr<Material> defaultMaterial;
+    std::vector<ModelPart> parts;
+    std::map<const Model*, bool> prepared;
+    for (const GltfPrimitive& primitive : asset.primitives) {
+        if (!prepared[primitive.model.get()]) {
+            prepareModel(*primitive.model, Model::TangentMode::MikkTSpace, options.quantize, true);
+            prepared[primitive.model.get()] = true;
+        }
+        std::shared_ptr<Material>& material = primitive.material >= 0 ? materials[primitive.material] : defaultMaterial;
+        if (!material && primitive.material >= 0) {
+            material = createGltfMaterial(asset.materials[primitive.material], textureOptions);
+        } else if (!material) {
+            // No material: the engine's default (the glTF default is a rough, fully metallic white)
+            material = std::make_shared<Material>();
+            material->shader = loadShader("BlinnPhong");
+        }
+        parts.push_back({primitive.model, material, primitive.transform});
+    }
+    gltfCache.insert(cacheKey, parts, gltfBytes(parts), getFrame());
+    return parts;
+}
+
+std::shared_ptr<Material> ResourceManager::createGltfMaterial(const GltfMaterial& source, const TextureLoadOptions& textureOptions) {
+    auto material = std::make_shared<Material>();
+    material->shader = loadShader("BlinnPhong");
+    vec3f baseColor(source.baseColorFactor.x, source.baseColorFactor.y, source.baseColorFactor.z);
+    material->diffuseColor = baseColor * (1.0f - source.metallicFactor);
+
+    // Metallic-roughness to Blinn-Phong: metals reflect their base color, dielectrics
+    // 4%; the exponent matches the highlight width of GGX at alpha = roughness^2
+    material->specularColor = vec3f(0.04f, 0.04f, 0.04f) * (1.0f - source.metallicFactor) + baseColor * source.metallicFactor;
+    float alpha = std::max(source.roughnessFactor * source.roughnessFactor, 0.03f);
+    material->shininess = std::clamp(static_cast<int>(2.0f / (alpha * alpha) - 2.0f), 1, 256);
+
+    auto texture = [&](const std::string& path, TextureUsage usage) -> std::shared_ptr<Texture> {
+        if (path.empty()) return nullptr;
+        TextureLoadOptions options = textureOptions;
+        options.usage = usage;
+        return loadTexture(path, options);
+    };
+    material->diffuseTexture = texture(source.baseColorTexture, TextureUsage::Color);
+    material->normalTexture = texture(source.normalTexture, TextureUsage::Normal);
+    material->aoTexture = texture(source.occlusionTexture, TextureUsage::Scalar); // Occlusion is R, also in packed ORM maps
+    return material;
+}
+
+
+// --- Asynchronous Loading ---
+
+ThreadPool* ResourceManager::loadPool() const {
+    return loaderPool && loaderPool->getCurrentWorkerIndex() >= 0 ? loadWorkerPool : workerPool;
+}
+
+template <typename T>
+std::shared_future<T> ResourceManager::loadAsync(const ResourceCache<T>& cache, std::map<std::string, std::shared_future<T>>& pending,
+                                                 const std::string& cacheKey, std::function<T()> load) {
+    T cached;
+    if (cache.find(cacheKey, cached, getFrame())) return readyFuture(std::move(cached));
+    std::unique_lock<std::mutex> lock(pendingMutex);
+    // Loads cache their result before leaving `pending`, so look again under the lock
+    if (cache.find(cacheKey, cached, getFrame())) return readyFuture(std::move(cached));
+    auto loading = pending.find(cacheKey);
+    if (loading != pending.end()) return loading->second;
+    if (!loaderPool) {
+        lock.unlock();
+        return readyFuture(load());
+    }
+
+    auto promise = std::make_shared<std::promise<T>>();
+    std::shared_future<T> future = promise->get_future().share();
+    pending[cacheKey] = future;
+    lock.unlock();
+    loaderPool->enqueue([this, promise, load = std::move(load), &pending, cacheKey]() {
+        T result = load();
+        {
+            std::lock_guard<std::mutex> lock(pendingMutex);
+            pending.erase(cacheKey);
+        }
+        promise->set_value(std::move(result)); // Last: the manager may be gone once it is set
+    });
+    return future;
+}
+
+template <typename T>
+void ResourceManager::waitForLoads(const std::map<std::string, std::shared_future<T>>& pending) {
+    std::vector<std::shared_future<T>> futures;
+    {
+        std::lock_guard<std::mutex> lock(pendingMutex);
+        for (const auto& [key, future] : pending) futures.push_back(future);
+    }
+    for (const auto& future : futures) future.wait();
+}
+
+ResourceManager::~ResourceManager() {
+    // Loads still running on the loader pool use the manager
+    waitForLoads(pendingModels);
+    waitForLoads(pendingGltfs);
+    waitForLoads(pendingTextures);
+}
+
+std::shared_future<std::shared_ptr<Model>> ResourceManager::loadModelAsync(const std::string& filename) {
+    // With the options of this call, which the key was made from
+    return loadAsync<std::shared_ptr<Model>>(modelCache, pendingModels, modelOptions.cacheKey(filename),
+                                             [this, filename, options = modelOptions, cacheDirectory = modelCacheDirectory]() {
+                                                 return loadModel(filename, options, cacheDirectory);
+                                             });
+}
+
+std::shared_future<std::vector<ModelPart>> ResourceManager::loadGltfAsync(const std::string& filename, const TextureLoadOptions& textureOptions) {
+    return loadAsync<std::vector<ModelPart>>(gltfCache, pendingGltfs, modelOptions.cacheKey(filename) + "|" + textureOptions.cacheKey(""),
+                                             [this, filename, textureOptions, options = modelOptions]() {
+                                                 return loadGltf(filename, textureOptions, options);
+                                             });
+}
+
+std::shared_future<std::shared_ptr<Texture>> ResourceManager::loadTextureAsync(const std::string& filename, const TextureLoadOptions& options) {
+    return loadAsync<std::shared_ptr<Texture>>(textureCache, pendingTextures, options.cacheKey(filename),
+                                               [this, filename, options]() { return loadTexture(filename, options); });
+}
+
+std::shared_future<std::shared_ptr<Texture>> ResourceManager::loadPackedTextureAsync(const std::string (&channelFiles)[3], const TextureLoadOptions& options) {
+    std::array<std::string, 3> files = {channelFiles[0], channelFiles[1], channelFiles[2]};
+    return loadAsync<std::shared_ptr<Texture>>(textureCache, pendingTextures, packedCacheKey(channelFiles, options),
+                                               [this, files, options]() {
+                                                   std::string channels[3] = {files[0], files[1], files[2]};
+                                                   return loadPackedTexture(channels, options);
+                                               });
+}
+
+std::shared_ptr<Model> ResourceManager::getPlaceholderModel() const {
+    static const std::shared_ptr<Model> emptyModel = std::make_shared<Model>();
+    return emptyModel;
+}
+
+std::shared_ptr<Texture> ResourceManager::getPlaceholderTexture(TextureUsage usage) const {
+    static const std::shared_ptr<Texture> white = SolidTexture::create(vec3f(1.0f, 1.0f, 1.0f), TextureUsage::Color);
+    static const std::shared_ptr<Texture> flatNormal = SolidTexture::create(vec3f(0.0f, 0.0f, 1.0f), TextureUsage::Normal);
+    switch (usage) {
+        case TextureUsage::Color:  return white;
+        case TextureUsage::Normal: return flatNormal;
+        default:                   return nullptr;
+    }
+}
+
 
 // --- Shader Loading (Example) ---
 
 std::shared_ptr<Shader> ResourceManager::loadShader(const std::string& name) {
      // Check cache
-    auto it = shaderCache.find(name);
-    if (it != shaderCache.end()) {
+    std::shared_ptr<Shader> cachedShader;
+    if (shaderCache.find(name, cachedShader, getFrame())) {
         // std::cout << "Cache hit for shader: " << name << std::endl;
-        return it->second;
+        return cachedShader;
     }
 
     std::cout << "Loading shader: " << name << std::endl;
 
     std::shared_ptr<Shader> shader = nullptr;
+    size_t shaderBytes = 0;
 
     // Simple example: Create known shaders by name
     if (name == "BlinnPhong") {
         shader = std::make_shared<BlinnPhongShader>();
+        shaderBytes = sizeof(BlinnPhongShader);
     }
     // Add cases for other shaders...
     // else if (name == "Unlit") { shader = std::make_shared<UnlitShader>(); }
@@ -182,7 +554,7 @@ std::shared_ptr<Shader> ResourceManager::loadShader(const std::string& name) {
     }
 
     if (shader) {
-        shaderCache[name] = shader;
+        shaderCache.insert(name, shader, shaderBytes, getFrame());
         std::cout << "\033[32m Successfully loaded shader: " << name << "\033[0m " << std::endl;
         return shader;
     } else {
@@ -194,37 +566,63 @@ std::shared_ptr<Shader> ResourceManager::loadShader(const std::string& name) {
 }
 
 
-// --- Optional: Cache Management ---
-void ResourceManager::clearUnused() {
-    // Implement logic to clear resources with shared_ptr use_count == 1 (only held by cache)
-    // Be careful with dependencies (e.g., models might be needed even if not drawn this frame)
-    std::cout << "Clearing unused resources..." << std::endl;
-    // Example for textures:
-    for (auto it = textureCache.begin(); it != textureCache.end(); /* no increment */) {
-        if (it->second.use_count() == 1) {
-            std::cout << "Unloading unused texture: " << it->first << std::endl;
-            it = textureCache.erase(it);
-        } else {
-            ++it;
-        }
-    }
+// --- Cache Management ---
 
-    for (auto it = modelCache.begin(); it != modelCache.end(); /* no increment */) {
-        if (it->second.use_count() == 1) {
-            std::cout << "Unloading unused model: " << it->first << std::endl;
-            it = modelCache.erase(it);
-        } else {
-            ++it;
-        }
+size_t ResourceManager::getResidentBytes() const {
+    return modelCache.getBytes() + gltfCache.getBytes() + textureCache.getBytes() + shaderCache.getBytes();
+}
+
+size_t ResourceManager::evictIdle(size_t targetBytes) {
+    uint32_t currentFrame = getFrame();
+    std::vector<EvictionCandidate> candidates;
+    collectIdle(modelCache, 0, currentFrame, candidates);
+    collectIdle(gltfCache, 1, currentFrame, candidates);
+    collectIdle(textureCache, 2, currentFrame, candidates);
+    collectIdle(shaderCache, 3, currentFrame, candidates);
+
+    size_t residentBytes = getResidentBytes();
+    if (residentBytes <= targetBytes || candidates.empty()) return 0;
+
+    // Least recently used first
+    std::sort(candidates.begin(), candidates.end(),
+              [](const EvictionCandidate& a, const EvictionCandidate& b) { return a.lastUsedFrame < b.lastUsedFrame; });
+    std::vector<std::pair<std::string, uint32_t>> keys[4];
+    size_t listedBytes = 0;
+    for (const EvictionCandidate& candidate : candidates) {
+        if (residentBytes - listedBytes <= targetBytes) break;
+        keys[candidate.cache].emplace_back(candidate.key, candidate.lastUsedFrame);
+        listedBytes += candidate.bytes;
     }
+    // Lookups may have reached the candidates since they were collected: erase only those still idle
+    auto idle = [](const auto& resource) { return isIdle(resource); };
+    size_t evictedBytes = 0;
+    size_t evicted = modelCache.eraseIdle(keys[0], idle, evictedBytes) + gltfCache.eraseIdle(keys[1], idle, evictedBytes) +
+                     textureCache.eraseIdle(keys[2], idle, evictedBytes) + shaderCache.eraseIdle(keys[3], idle, evictedBytes);
+    if (evicted == 0) return 0;
+    evictedCount += evicted;
+
+    std::cout << "Evicted " << evicted << " idle resources (" << evictedBytes / 1024 << " KB), "
+        << getResidentBytes() / 1024 << " KB resident" << std::endl;
+    return evicted;
+}
 
-    for (auto it = shaderCache.begin(); it != shaderCache.end(); /* no increment */) {
-        if (it->second.use_count() == 1) {
-            std::cout << "Unloading unused shader: " << it->first << std::endl;
-            it = shaderCache.erase(it);
-        } else {
-            ++it;
-        }
+void ResourceManager::update() {
+    virtualTextures.update();
+
+    // Also marks the resources in use, so run it every frame
+    evictIdle(memoryBudget > 0 ? memoryBudget : SIZE_MAX);
+    bool overBudget = memoryBudget > 0 && getResidentBytes() > memoryBudget;
+    if (overBudget && !overBudgetReported) {
+        std::cerr << "\033[31m Warning: Resources in use exceed the memory budget (" << getResidentBytes() / 1024 << " KB of "
+            << memoryBudget / 1024 << " KB) \033[0m" << std::endl;
     }
+    overBudgetReported = overBudget;
+
+    frame.fetch_add(1, std::memory_order_relaxed);
+}
+
+void ResourceManager::clearUnused() {
+    // Evicted glTF assets and materials may have held the last other references to textures and shaders
+    while (evictIdle(0) > 0) {}
+}
 
-}
\ No newline at end of file
@@ -2,10 +2,26 @@
 #include "core/scene.h"
 #include "core/resource_manager.h" 
 #include "core/blinn_phong_shader.h"
+#include "core/texture/packed_texture.h"
 #include <yaml-cpp/yaml.h>
+#include <chrono>
 #include <iostream>
 #include "io/debug.h"
 
+namespace { // Anonymous namespace for internal linkage helper functions
+
+    // Pending load that passes the result to apply() once the future is ready
+    template <typename T, typename Apply>
+    std::function<bool()> whenReady(std::shared_future<T> future, Apply apply) {
+        return [future, apply]() {
+            if (future.wait_for(std::chrono::seconds(0)) != std::future_status::ready) return false;
+            apply(future.get());
+            return true;
+        };
+    }
+
+} // end anonymous namespace
+
 Scene::Scene(int width, int height, ResourceManager& resManager)
     : resourceManager(resManager), camera({0.0f, 0.0f, 5.0f}, -90.0f, 0.0f) {
     std::cout << "Scene::Scene" << std::endl; 
@@ -14,6 +30,7 @@ Scene::Scene(int width, int height, ResourceManager& resManager)
 
 
 void Scene::update(float deltaTime) {
+    applyFinishedLoads();
     for (auto& obj : objects) {
         if (obj.animation.type == SceneObject::Animation::Type::RotateY) {  
             float angle = obj.transform.getRotationEulerZYX().y + obj.animation.speed * deltaTime;
@@ -23,13 +40,39 @@ void Scene::update(float deltaTime) {
     }
 }
 
+void Scene::applyFinishedLoads() {
+    if (pendingLoads.empty()) return;
+    // Runs between frames: no draw sees a resource change half way
+    std::erase_if(pendingLoads, [](const std::function<bool()>& apply) { return apply(); });
+    if (pendingLoads.empty()) {
+        Debug::LogOK("All scene assets loaded.");
+    }
+}
+
 void Scene::render(Renderer& renderer) {
+    cullStats = {};
     for (const auto& obj : objects) {
+        if (!obj.modelPtr) {
+            cullStats.missing++;
+            continue;
+        }
+        const Model& model = *obj.modelPtr;
+        mat4 modelMatrix = obj.transform.getTransformMatrix() * obj.localTransform.getTransformMatrix();
+
+        // Test in model space, against the load time bounds: the sphere first
+        // (cheaper), then the box, which is tighter for elongated models
+        Frustum frustum = camera.getFrustum(modelMatrix);
+        if (frustum.sphereOutside(model.getBoundsCenter(), model.boundsRadius) ||
+            frustum.boxOutside(model.boundsMin, model.boundsMax)) {
+            cullStats.culled++;
+            continue;
+        }
+        cullStats.visible++;
 
         DrawCommand command;
-        command.model = obj.modelPtr.get();
+        command.model = &model;
         command.material = obj.materialPtr.get();
-        command.modelMatrix = obj.transform.getTransformMatrix();
+        command.modelMatrix = modelMatrix;
 
         renderer.submit(command);
     }
@@ -104,16 +147,105 @@ bool Scene::loadFromYAML(const std::string& filename) {
             Debug::LogWarning("Warning: 'light' node not found in scene file.");
         }
 
+        // Texture loading options shared by all materials
+        TextureLoadOptions textureDefaults;
+        auto texturesNode = config["textures"];
+        if (texturesNode && texturesNode["keep_compressed"]) {
+            textureDefaults.keepCompressed = texturesNode["keep_compressed"].as<bool>();
+        }
+        if (texturesNode && texturesNode["compress_on_load"]) {
+            textureDefaults.compressOnLoad = texturesNode["compress_on_load"].as<bool>();
+        }
+        if (texturesNode && texturesNode["layout"]) {
+            std::string layout = texturesNode["layout"].as<std::string>();
+            if (layout == "tiled") textureDefaults.layout = TexelLayout::Tiled4x4;
+            else if (layout == "linear") textureDefaults.layout = TexelLayout::Linear;
+            else Debug::LogWarning("Warning: Unknown texture layout '{}', using linear.", layout);
+        }
+        if (texturesNode && texturesNode["mip_filter"]) {
+            std::string filter = texturesNode["mip_filter"].as<std::string>();
+            if (filter == "box") textureDefaults.mipFilter = MipFilter::Box;
+            else if (filter == "kaiser") textureDefaults.mipFilter = MipFilter::Kaiser;
+            else if (filter == "lanczos") textureDefaults.mipFilter = MipFilter::Lanczos;
+            else Debug::LogWarning("Warning: Unknown mip filter '{}', using box.", filter);
+        }
+        if (texturesNode && texturesNode["gamma_correct_mips"]) {
+            textureDefaults.gammaCorrectMips = texturesNode["gamma_correct_mips"].as<bool>();
+        }
+        // Preprocessed texture cache, filled on first load; an empty string disables it
+        std::string textureCacheDirectory = ".texture_cache";
+        if (texturesNode && texturesNode["cache_dir"]) {
+            textureCacheDirectory = texturesNode["cache_dir"].as<std::string>();
+        }
+        resourceManager.setTextureCacheDirectory(textureCacheDirectory);
+        if (texturesNode && texturesNode["virtual"]) {
+            textureDefaults.virtualTexture = texturesNode["virtual"].as<bool>();
+        }
+        if (texturesNode && texturesNode["page_budget_mb"]) {
+            resourceManager.getVirtualTextureCache().setBudget(texturesNode["page_budget_mb"].as<size_t>() << 20);
+        }
+        // Pack specular and gloss into one texture when a material has both
+        bool packScalarMaps = true;
+        if (texturesNode && texturesNode["pack_scalar_maps"]) {
+            packScalarMaps = texturesNode["pack_scalar_maps"].as<bool>();
+        }
+        auto textureOptions = [&textureDefaults](TextureUsage usage) {
+            TextureLoadOptions options = textureDefaults;
+            options.usage = usage;
+            return options;
+        };
+        // Material textures start as placeholders and are swapped in by update()
+        auto loadTexture = [this, &textureOptions](const std::shared_ptr<Material>& material, std::shared_ptr<Texture> Material::*slot,
+                                                   const std::string& file, TextureUsage usage) {
+            (*material).*slot = resourceManager.getPlaceholderTexture(usage);
+            pendingLoads.push_back(whenReady(resourceManager.loadTextureAsync(file, textureOptions(usage)),
+                [material, slot](const std::shared_ptr<Texture>& texture) { (*material).*slot = texture; }));
+        };
+
+        // Binary model cache, filled on first load; an empty string disables it
+        auto modelsNode = config["models"];
+        std::string modelCacheDirectory = ".model_cache";
+        if (modelsNode && modelsNode["cache_dir"]) {
+            modelCacheDirectory = modelsNode["cache_dir"].as<std::string>();
+        }
+        resourceManager.setModelCacheDirectory(modelCacheDirectory);
+        // Tangent space ("accumulate" or "mikktspace", for normal maps baked with it) and
+        // quantization (16-bit positions, octahedral normals and tangents, half float UVs)
+        ModelLoadOptions modelOptions;
+        if (modelsNode && modelsNode["tangents"] && modelsNode["tangents"].as<std::string>() == "mikktspace") {
+            modelOptions.tangentMode = Model::TangentMode::MikkTSpace;
+        }
+        modelOptions.quantize = modelsNode && modelsNode["quantize"] && modelsNode["quantize"].as<bool>();
+        resourceManager.setModelLoadOptions(modelOptions);
+
+        // Memory budget of the resource caches (idle resources past it are evicted)
+        auto resourcesNode = config["resources"];
+        if (resourcesNode && resourcesNode["budget_mb"]) {
+            resourceManager.setMemoryBudget(resourcesNode["budget_mb"].as<size_t>() << 20);
+        }
+
         // Load objects
         objects.clear();
+        pendingLoads.clear();
         auto objectsNode = config["objects"];
         if (objectsNode) {
             for (const auto& objNode : objectsNode) {
                 SceneObject obj;
 
-                // Load model using ResourceManager
+                // Load model using ResourceManager. A glTF asset becomes one object per
+                // primitive, with its own materials unless the entry gives one.
                 std::string modelPath = objNode["model"].as<std::string>();
-                obj.modelPtr = resourceManager.loadModel(modelPath); // Use ResourceManage
+                std::string lowerModelPath = modelPath;
+                for (char& c : lowerModelPath) c = static_cast<char>(tolower(c));
+                bool gltf = lowerModelPath.ends_with(".gltf") || lowerModelPath.ends_with(".glb");
+                std::shared_future<std::vector<ModelPart>> parts;
+                std::shared_future<std::shared_ptr<Model>> model;
+                if (gltf) {
+                    parts = resourceManager.loadGltfAsync(modelPath, textureOptions(TextureUsage::Color));
+                } else {
+                    obj.modelPtr = resourceManager.getPlaceholderModel();
+                    model = resourceManager.loadModelAsync(modelPath); // Use ResourceManage
+                }
 
                 // Load material properties and textures using ResourceManager
                 auto matNode = objNode["material"];
@@ -125,19 +257,42 @@ bool Scene::loadFromYAML(const std::string& filename) {
                         obj.materialPtr->shader = resourceManager.loadShader(matNode["shader"].as<std::string>()); // Example shader loading
                     
                     if (matNode["diffuse_texture"])
-                        obj.materialPtr->diffuseTexture = resourceManager.loadTexture(matNode["diffuse_texture"].as<std::string>());
+                        loadTexture(obj.materialPtr, &Material::diffuseTexture, matNode["diffuse_texture"].as<std::string>(), TextureUsage::Color);
                     
                     if (matNode["normal_texture"])
-                        obj.materialPtr->normalTexture = resourceManager.loadTexture(matNode["normal_texture"].as<std::string>());
-                    
-                    if (matNode["ao_texture"])
-                        obj.materialPtr->aoTexture = resourceManager.loadTexture(matNode["ao_texture"].as<std::string>());
+                        loadTexture(obj.materialPtr, &Material::normalTexture, matNode["normal_texture"].as<std::string>(), TextureUsage::Normal);
                     
-                    if (matNode["specular_texture"])    
-                        obj.materialPtr->specularTexture = resourceManager.loadTexture(matNode["specular_texture"].as<std::string>());
-                    
-                    if (matNode["gloss_texture"])
-                        obj.materialPtr->glossTexture = resourceManager.loadTexture(matNode["gloss_texture"].as<std::string>());
+                    // Scalar maps in packed channel order: specular (R), gloss (G), AO (B)
+                    std::string scalarFiles[3];
+                    if (matNode["specular_texture"]) scalarFiles[0] = matNode["specular_texture"].as<std::string>();
+                    if (matNode["gloss_texture"]) scalarFiles[1] = matNode["gloss_texture"].as<std::string>();
+                    if (matNode["ao_texture"]) scalarFiles[2] = matNode["ao_texture"].as<std::string>();
+
+                    // Specular and gloss are read together: one RG8Unorm fetch instead of two
+                    // R8 ones, same memory. AO stays separate, as a third channel would cost a
+                    // byte per texel more than its own R8 map.
+                    if (!scalarFiles[2].empty())
+                        loadTexture(obj.materialPtr, &Material::aoTexture, scalarFiles[2], TextureUsage::Scalar);
+
+                    if (packScalarMaps && !scalarFiles[0].empty() && !scalarFiles[1].empty() && !textureDefaults.virtualTexture) {
+                        std::string packedFiles[3] = {scalarFiles[0], scalarFiles[1], ""};
+                        pendingLoads.push_back(whenReady(resourceManager.loadPackedTextureAsync(packedFiles, textureOptions(TextureUsage::Scalar)),
+                            [material = obj.materialPtr](const std::shared_ptr<Texture>& texture) {
+                                // Only the channels whose source loaded; the others keep the material constants
+                                auto packed = std::dynamic_pointer_cast<PackedTexture>(texture);
+                                if (!packed) return;
+                                material->packedScalarTexture = packed;
+                                material->packedSpecular = packed->hasChannel(0);
+                                material->packedGloss = packed->hasChannel(1);
+                                material->packedAo = packed->hasChannel(2);
+                            }));
+                    } else {
+                        if (!scalarFiles[0].empty())
+                            loadTexture(obj.materialPtr, &Material::specularTexture, scalarFiles[0], TextureUsage::Scalar);
+
+                        if (!scalarFiles[1].empty())
+                            loadTexture(obj.materialPtr, &Material::glossTexture, scalarFiles[1], TextureUsage::Scalar);
+                    }
                     
                     if (matNode["ambientColor"])
                         obj.materialPtr->ambientColor = matNode["ambientColor"].as<std::vector<float>>();
@@ -177,12 +332,29 @@ bool Scene::loadFromYAML(const std::string& filename) {
                     }
                 }
 
+                if (gltf) {
+                    pendingLoads.push_back(whenReady(parts, [this, obj](const std::vector<ModelPart>& loadedParts) {
+                        for (const ModelPart& part : loadedParts) {
+                            SceneObject partObject = obj;
+                            partObject.modelPtr = part.model;
+                            if (!partObject.materialPtr) partObject.materialPtr = part.material;
+                            partObject.localTransform = part.transform;
+                            objects.push_back(std::move(partObject));
+                        }
+                    }));
+                    continue;
+                }
+
+                pendingLoads.push_back(whenReady(model, [this, index = objects.size()](const std::shared_ptr<Model>& loadedModel) {
+                    objects[index].modelPtr = loadedModel;
+                }));
                 objects.push_back(std::move(obj)); // Move object into vector
             }
         } else {
             Debug::LogWarning("Warning: 'objects' node not found in scene file.");
         }
 
+        applyFinishedLoads(); // Everything, if there is no loader pool
         return true;
     } catch (const YAML::BadFile& e) {
         Debug::LogError("Error: Could not open or read YAML file '{}'.", filename);
@@ -13,11 +13,15 @@ SDLApp::SDLApp(int w, int h, const std::string& t)
       window(nullptr), sdlRenderer(nullptr), framebufferTexture(nullptr), 
       quit(false), deltaTime(0.0f), frameCount(0), fps(0.0f),
       lastFrameTime(0), fpsUpdateTimer(0),
-      resourceManager(), scene(w, h, resourceManager), 
+      resourceManager(), loadWorkerPool(std::max(1u, std::thread::hardware_concurrency() - 1)),
+      loaderPool(std::max(1u, std::thread::hardware_concurrency() - 1)), scene(w, h, resourceManager), 
       framebuffer(w, h, threadPool),
       renderer(framebuffer, threadPool) 
 {
     std::cout << "Initializing SDLApp with " << threadPool.getNumThreads() << " threads." << std::endl;
+    resourceManager.setWorkerPool(&threadPool); // Scene loading runs before the render loop uses the pool
+    resourceManager.setLoaderPool(&loaderPool);
+    resourceManager.setLoadWorkerPool(&loadWorkerPool);
 }
 
 
@@ -234,6 +238,7 @@ void SDLApp::updateFPS() {
 }
 
 void SDLApp::update(float dt) {
+    resourceManager.update(); // Between frames: no sampling in flight
     scene.update(dt);
 }
 
@@ -301,6 +306,25 @@ void SDLApp::renderImGui() {
     ImGui::Text("Frame Time: %.3f ms", deltaTime * 1000.0f);
     ImGui::Text("Resolution: %d x %d", width, height);
     ImGui::Text("Threads: %d", threadPool.getNumThreads());
+    if (scene.getNumPendingLoads() > 0) ImGui::Text("Loading: %zu assets", scene.getNumPendingLoads());
+    ImGui::Text("Frame Arena: %.1f KB (peak %.1f KB)",
+        renderer.getFrameArenaUsed() / 1024.0f, renderer.getFrameArenaHighWaterMark() / 1024.0f);
+    CullStats cullStats = scene.getCullStats();
+    ImGui::Text("Objects: %zu drawn / %zu (frustum culled %zu, missing %zu)", cullStats.visible,
+        cullStats.visible + cullStats.culled + cullStats.missing, cullStats.culled, cullStats.missing);
+    MeshletStats meshletStats = renderer.getMeshletStats();
+    ImGui::Text("Meshlets: %zu drawn / %zu (culled: frustum %zu, backface %zu, Hi-Z %zu)",
+        meshletStats.total - meshletStats.frustumCulled - meshletStats.backfaceCulled - meshletStats.occlusionCulled,
+        meshletStats.total, meshletStats.frustumCulled, meshletStats.backfaceCulled, meshletStats.occlusionCulled);
+    const VirtualTextureCache& pageCache = resourceManager.getVirtualTextureCache();
+    ImGui::Text("VT Pages: %zu (%.1f / %.1f MB)", pageCache.getResidentPages(),
+        pageCache.getResidentBytes() / (1024.0f * 1024.0f), pageCache.getBudget() / (1024.0f * 1024.0f));
+    if (resourceManager.getMemoryBudget() > 0) {
+        ImGui::Text("Resources: %.1f / %.1f MB (evicted %zu)", resourceManager.getResidentBytes() / (1024.0f * 1024.0f),
+            resourceManager.getMemoryBudget() / (1024.0f * 1024.0f), resourceManager.getEvictedCount());
+    } else {
+        ImGui::Text("Resources: %.1f MB", resourceManager.getResidentBytes() / (1024.0f * 1024.0f));
+    }
     ImGui::Text(mouseLookActive ? "Mouse Look: ON" : "Mouse Look: OFF (Press Esc)");
     ImGui::End(); // End Status
 
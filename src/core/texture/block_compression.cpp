@@ -0,0 +1,532 @@
+// src/core/texture/block_compression.cpp
+#include "core/texture/block_compression.h"
+#include "core/threadpool.h"
+#include <cstring>
+#include <utility>
+
+namespace { // Anonymous namespace for internal linkage helper functions
+
+    // --- BC1 color part / BC3, BC4, BC5 channel blocks ---
+
+    // BC1 palette as packed RGBA8. BC3 always uses the four color mode, BC1
+    // switches to three colors + transparent black when c0 <= c1.
+    void colorPalette(const unsigned char* block, bool allowThreeColor, uint32_t palette[4]) {
+        uint16_t c0 = block[0] | (block[1] << 8);
+        uint16_t c1 = block[2] | (block[3] << 8);
+
+        unsigned char rgba[4][4];
+        auto expand565 = [](uint16_t c, unsigned char* out) {
+            int r = (c >> 11) & 31, g = (c >> 5) & 63, b = c & 31;
+            out[0] = static_cast<unsigned char>((r << 3) | (r >> 2));
+            out[1] = static_cast<unsigned char>((g << 2) | (g >> 4));
+            out[2] = static_cast<unsigned char>((b << 3) | (b >> 2));
+            out[3] = 255;
+        };
+        expand565(c0, rgba[0]);
+        expand565(c1, rgba[1]);
+
+        if (c0 > c1 || !allowThreeColor) {
+            for (int ch = 0; ch < 3; ++ch) {
+                rgba[2][ch] = static_cast<unsigned char>((2 * rgba[0][ch] + rgba[1][ch] + 1) / 3);
+                rgba[3][ch] = static_cast<unsigned char>((rgba[0][ch] + 2 * rgba[1][ch] + 1) / 3);
+            }
+            rgba[2][3] = rgba[3][3] = 255;
+        } else {
+            for (int ch = 0; ch < 3; ++ch) {
+                rgba[2][ch] = static_cast<unsigned char>((rgba[0][ch] + rgba[1][ch] + 1) / 2);
+                rgba[3][ch] = 0;
+            }
+            rgba[2][3] = 255;
+            rgba[3][3] = 0; // Transparent black
+        }
+        std::memcpy(palette, rgba, sizeof(rgba));
+    }
+
+    // Eight values of a single 8-bit channel block (BC3 alpha, BC4, each half of BC5)
+    void channelPalette(const unsigned char* block, unsigned char values[8]) {
+        int a0 = block[0], a1 = block[1];
+        values[0] = static_cast<unsigned char>(a0);
+        values[1] = static_cast<unsigned char>(a1);
+        if (a0 > a1) {
+            for (int i = 0; i < 6; ++i) values[i + 2] = static_cast<unsigned char>(((6 - i) * a0 + (i + 1) * a1 + 3) / 7);
+        } else {
+            for (int i = 0; i < 4; ++i) values[i + 2] = static_cast<unsigned char>(((4 - i) * a0 + (i + 1) * a1 + 2) / 5);
+            values[6] = 0;
+            values[7] = 255;
+        }
+    }
+
+    inline uint64_t channelLookup(const unsigned char* block) {
+        uint64_t lookup = 0;
+        for (int i = 0; i < 6; ++i) lookup |= static_cast<uint64_t>(block[2 + i]) << (i * 8);
+        return lookup;
+    }
+
+    inline uint32_t colorLookup(const unsigned char* block) {
+        return block[4] | (block[5] << 8) | (block[6] << 16) | (static_cast<uint32_t>(block[7]) << 24);
+    }
+
+#ifdef NaiveMethod
+    void decodeColorBlock(const unsigned char* block, bool allowThreeColor, unsigned char out[16][4]) {
+        uint32_t palette[4];
+        colorPalette(block, allowThreeColor, palette);
+        uint32_t lookup = colorLookup(block);
+        for (int i = 0; i < 16; ++i) std::memcpy(out[i], &palette[(lookup >> (2 * i)) & 0x3], 4);
+    }
+
+    void decodeChannelBlock(const unsigned char* block, unsigned char out[16][4], int channel) {
+        unsigned char values[8];
+        channelPalette(block, values);
+        uint64_t lookup = channelLookup(block);
+        for (int i = 0; i < 16; ++i) out[i][channel] = values[(lookup >> (3 * i)) & 0x7];
+    }
+#else
+    // Palette lookup of all 16 texels by compare and select: each 2-bit index is
+    // compared against 0-3 and the matching palette entry masked in (SSE2 only)
+    void decodeColorBlock(const unsigned char* block, bool allowThreeColor, unsigned char out[16][4]) {
+        uint32_t palette[4];
+        colorPalette(block, allowThreeColor, palette);
+        uint32_t lookup = colorLookup(block);
+        __m128i entries[4];
+        for (int k = 0; k < 4; ++k) entries[k] = _mm_set1_epi32(static_cast<int>(palette[k]));
+        for (int row = 0; row < 4; ++row) {
+            uint32_t bits = lookup >> (8 * row);
+            __m128i index = _mm_set_epi32((bits >> 6) & 3, (bits >> 4) & 3, (bits >> 2) & 3, bits & 3);
+            __m128i color = _mm_and_si128(_mm_cmpeq_epi32(index, _mm_setzero_si128()), entries[0]);
+            for (int k = 1; k < 4; ++k) {
+                color = _mm_or_si128(color, _mm_and_si128(_mm_cmpeq_epi32(index, _mm_set1_epi32(k)), entries[k]));
+            }
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out[4 * row]), color);
+        }
+    }
+
+    // The 16 texel values of a channel block, one byte per texel
+    __m128i decodeChannelValues(const unsigned char* block) {
+        unsigned char values[8];
+        channelPalette(block, values);
+        uint64_t lookup = channelLookup(block);
+        alignas(16) unsigned char indices[16];
+        for (int i = 0; i < 16; ++i) indices[i] = static_cast<unsigned char>((lookup >> (3 * i)) & 0x7);
+
+        __m128i index = _mm_load_si128(reinterpret_cast<const __m128i*>(indices));
+        __m128i result = _mm_setzero_si128();
+        for (int k = 0; k < 8; ++k) {
+            __m128i match = _mm_cmpeq_epi8(index, _mm_set1_epi8(static_cast<char>(k)));
+            result = _mm_or_si128(result, _mm_and_si128(match, _mm_set1_epi8(static_cast<char>(values[k]))));
+        }
+        return result;
+    }
+
+    // Interleaves 16 bytes of two 16-bit channel pairs into 16 RGBA8 texels
+    inline void storeTexels(__m128i lowPairs, __m128i highPairs, __m128i lowPairs2, __m128i highPairs2, unsigned char out[16][4]) {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out[0]), _mm_unpacklo_epi16(lowPairs, lowPairs2));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out[4]), _mm_unpackhi_epi16(lowPairs, lowPairs2));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out[8]), _mm_unpacklo_epi16(highPairs, highPairs2));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out[12]), _mm_unpackhi_epi16(highPairs, highPairs2));
+    }
+#endif
+
+    // --- BC7 ---
+
+    struct BC7Mode {
+        uint8_t subsets;
+        uint8_t partitionBits;
+        uint8_t rotationBits;
+        uint8_t indexSelectionBits;
+        uint8_t colorBits;
+        uint8_t alphaBits;
+        uint8_t endpointPBits; // One p-bit per endpoint
+        uint8_t sharedPBits;   // One p-bit per subset
+        uint8_t indexBits;
+        uint8_t indexBits2;    // Separate alpha (or color) indices, modes 4 and 5
+    };
+
+    constexpr BC7Mode BC7Modes[8] = {
+        {3, 4, 0, 0, 4, 0, 1, 0, 3, 0},
+        {2, 6, 0, 0, 6, 0, 0, 1, 3, 0},
+        {3, 6, 0, 0, 5, 0, 0, 0, 2, 0},
+        {2, 6, 0, 0, 7, 0, 1, 0, 2, 0},
+        {1, 0, 2, 1, 5, 6, 0, 0, 2, 3},
+        {1, 0, 2, 0, 7, 8, 0, 0, 2, 2},
+        {1, 0, 0, 0, 7, 7, 1, 0, 4, 0},
+        {2, 6, 0, 0, 5, 5, 1, 0, 2, 0},
+    };
+
+    // Subset of each texel, one bit per texel (two subset partitions)
+    constexpr uint16_t BC7Partitions2[64] = {
+        0xCCCC, 0x8888, 0xEEEE, 0xECC8, 0xC880, 0xFEEC, 0xFEC8, 0xEC80,
+        0xC800, 0xFFEC, 0xFE80, 0xE800, 0xFFE8, 0xFF00, 0xFFF0, 0xF000,
+        0xF710, 0x008E, 0x7100, 0x08CE, 0x008C, 0x7310, 0x3100, 0x8CCE,
+        0x088C, 0x3110, 0x6666, 0x366C, 0x17E8, 0x0FF0, 0x718E, 0x399C,
+        0xAAAA, 0xF0F0, 0x5A5A, 0x33CC, 0x3C3C, 0x55AA, 0x9696, 0xA55A,
+        0x73CE, 0x13C8, 0x324C, 0x3BDC, 0x6996, 0xC33C, 0x9966, 0x0660,
+        0x0272, 0x04E4, 0x4E40, 0x2720, 0xC936, 0x936C, 0x39C6, 0x639C,
+        0x9336, 0x9CC6, 0x817E, 0xE718, 0xCCF0, 0x0FCC, 0x7744, 0xEE22,
+    };
+
+    // Subset of each texel, two bits per texel (three subset partitions)
+    constexpr uint32_t BC7Partitions3[64] = {
+        0xAA685050, 0x6A5A5040, 0x5A5A4200, 0x5450A0A8, 0xA5A50000, 0xA0A05050, 0x5555A0A0, 0x5A5A5050,
+        0xAA550000, 0xAA555500, 0xAAAA5500, 0x90909090, 0x94949494, 0xA4A4A4A4, 0xA9A59450, 0x2A0A4250,
+        0xA5945040, 0x0A425054, 0xA5A5A500, 0x55A0A0A0, 0xA8A85454, 0x6A6A4040, 0xA4A45000, 0x1A1A0500,
+        0x0050A4A4, 0xAAA59090, 0x14696914, 0x69691400, 0xA08585A0, 0xAA821414, 0x50A4A450, 0x6A5A0200,
+        0xA9A58000, 0x5090A0A8, 0xA8A09050, 0x24242424, 0x00AA5500, 0x24924924, 0x24499224, 0x50A50A50,
+        0x500AA550, 0xAAAA4444, 0x66660000, 0xA5A0A5A0, 0x50A050A0, 0x69286928, 0x44AAAA44, 0x66666600,
+        0xAA444444, 0x54A854A8, 0x95809580, 0x96969600, 0xA85454A8, 0x80959580, 0xAA141414, 0x96960000,
+        0xAAAA1414, 0xA05050A0, 0xA0A5A5A0, 0x96000000, 0x40804080, 0xA9A8A9A8, 0xAAAAAA44, 0x2A4A5254,
+    };
+
+    // Anchor texels (index stored with one bit less) of the second subset of
+    // two subset partitions, and of the second / third subset of three subset ones
+    constexpr uint8_t BC7Anchor2[64] = {
+        15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15,
+        15,  2,  8,  2,  2,  8,  8, 15,  2,  8,  2,  2,  8,  8,  2,  2,
+        15, 15,  6,  8,  2,  8, 15, 15,  2,  8,  2,  2,  2, 15, 15,  6,
+         6,  2,  6,  8, 15, 15,  2,  2, 15, 15, 15, 15, 15,  2,  2, 15,
+    };
+    constexpr uint8_t BC7Anchor3a[64] = {
+         3,  3, 15, 15,  8,  3, 15, 15,  8,  8,  6,  6,  6,  5,  3,  3,
+         3,  3,  8, 15,  3,  3,  6, 10,  5,  8,  8,  6,  8,  5, 15, 15,
+         8, 15,  3,  5,  6, 10,  8, 15, 15,  3, 15,  5, 15, 15, 15, 15,
+         3, 15,  5,  5,  5,  8,  5, 10,  5, 10,  8, 13, 15, 12,  3,  3,
+    };
+    constexpr uint8_t BC7Anchor3b[64] = {
+        15,  8,  8,  3, 15, 15,  3,  8, 15, 15, 15, 15, 15, 15, 15,  8,
+        15,  8, 15,  3, 15,  8, 15,  8,  3, 15,  6, 10, 15, 15, 10,  8,
+        15,  3, 15, 10, 10,  8,  9, 10,  6, 15,  8, 15,  3,  6,  6,  8,
+        15,  3, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15,  3, 15, 15,  8,
+    };
+
+    constexpr uint8_t BC7Weights2[4] = {0, 21, 43, 64};
+    constexpr uint8_t BC7Weights3[8] = {0, 9, 18, 27, 37, 46, 55, 64};
+    constexpr uint8_t BC7Weights4[16] = {0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64};
+
+    inline const uint8_t* bc7Weights(int indexBits) {
+        return indexBits == 2 ? BC7Weights2 : (indexBits == 3 ? BC7Weights3 : BC7Weights4);
+    }
+
+    // LSB-first reader over the 128 bits of a block
+    struct BlockBits {
+        uint64_t low, high;
+        int position = 0;
+
+        explicit BlockBits(const unsigned char* block) {
+            std::memcpy(&low, block, 8);
+            std::memcpy(&high, block + 8, 8);
+        }
+
+        uint32_t read(int count) {
+            if (count == 0) return 0;
+            uint64_t value;
+            if (position >= 64) value = high >> (position - 64);
+            else if (position + count <= 64) value = low >> position;
+            else value = (low >> position) | (high << (64 - position));
+            position += count;
+            return static_cast<uint32_t>(value) & ((1u << count) - 1);
+        }
+    };
+
+    // Unquantized endpoint: bit replication from `bits` to 8 bits
+    inline uint8_t expandBits(uint32_t value, int bits) {
+        value <<= 8 - bits;
+        return static_cast<uint8_t>(value | (value >> bits));
+    }
+
+    void decodeBC7Block(const unsigned char* block, unsigned char out[16][4]) {
+        int mode = 0;
+        while (mode < 8 && !(block[0] & (1 << mode))) ++mode;
+        if (mode == 8) { // Reserved mode: transparent black
+            std::memset(out, 0, 16 * 4);
+            return;
+        }
+        const BC7Mode& m = BC7Modes[mode];
+        BlockBits bits(block);
+        bits.read(mode + 1);
+        int partition = static_cast<int>(bits.read(m.partitionBits));
+        int rotation = static_cast<int>(bits.read(m.rotationBits));
+        int indexSelection = static_cast<int>(bits.read(m.indexSelectionBits));
+
+        // Endpoints: all reds, then greens, blues, alphas; then the p-bits
+        int numEndpoints = m.subsets * 2;
+        uint32_t endpoints[6][4];
+        for (int c = 0; c < 3; ++c) {
+            for (int e = 0; e < numEndpoints; ++e) endpoints[e][c] = bits.read(m.colorBits);
+        }
+        for (int e = 0; e < numEndpoints; ++e) endpoints[e][3] = m.alphaBits ? bits.read(m.alphaBits) : 255u;
+
+        int colorBits = m.colorBits, alphaBits = m.alphaBits;
+        if (m.endpointPBits || m.sharedPBits) {
+            uint32_t pBits[6];
+            if (m.endpointPBits) {
+                for (int e = 0; e < numEndpoints; ++e) pBits[e] = bits.read(1);
+            } else {
+                for (int s = 0; s < m.subsets; ++s) pBits[2 * s] = pBits[2 * s + 1] = bits.read(1);
+            }
+            for (int e = 0; e < numEndpoints; ++e) {
+                for (int c = 0; c < 3; ++c) endpoints[e][c] = (endpoints[e][c] << 1) | pBits[e];
+                if (alphaBits) endpoints[e][3] = (endpoints[e][3] << 1) | pBits[e];
+            }
+            colorBits++;
+            if (alphaBits) alphaBits++;
+        }
+        uint8_t colors[6][4];
+        for (int e = 0; e < numEndpoints; ++e) {
+            for (int c = 0; c < 3; ++c) colors[e][c] = expandBits(endpoints[e][c], colorBits);
+            colors[e][3] = alphaBits ? expandBits(endpoints[e][3], alphaBits) : 255;
+        }
+
+        // Subset and anchor texels
+        uint8_t subset[16];
+        for (int i = 0; i < 16; ++i) {
+            if (m.subsets == 2) subset[i] = (BC7Partitions2[partition] >> i) & 1;
+            else if (m.subsets == 3) subset[i] = (BC7Partitions3[partition] >> (2 * i)) & 3;
+            else subset[i] = 0;
+        }
+        auto isAnchor = [&](int i) {
+            if (i == 0) return true;
+            if (m.subsets == 2) return i == BC7Anchor2[partition];
+            if (m.subsets == 3) return i == BC7Anchor3a[partition] || i == BC7Anchor3b[partition];
+            return false;
+        };
+
+        uint8_t indices[16], indices2[16] = {};
+        for (int i = 0; i < 16; ++i) indices[i] = static_cast<uint8_t>(bits.read(m.indexBits - (isAnchor(i) ? 1 : 0)));
+        if (m.indexBits2) {
+            for (int i = 0; i < 16; ++i) indices2[i] = static_cast<uint8_t>(bits.read(m.indexBits2 - (i == 0 ? 1 : 0)));
+        }
+
+        const uint8_t* weights = bc7Weights(m.indexBits);
+        const uint8_t* weights2 = m.indexBits2 ? bc7Weights(m.indexBits2) : weights;
+        for (int i = 0; i < 16; ++i) {
+            const uint8_t* e0 = colors[2 * subset[i]];
+            const uint8_t* e1 = colors[2 * subset[i] + 1];
+            int colorWeight, alphaWeight;
+            if (!m.indexBits2) {
+                colorWeight = alphaWeight = weights[indices[i]];
+            } else if (indexSelection) { // Mode 4: 3-bit indices for color, 2-bit for alpha
+                colorWeight = weights2[indices2[i]];
+                alphaWeight = weights[indices[i]];
+            } else {
+                colorWeight = weights[indices[i]];
+                alphaWeight = weights2[indices2[i]];
+            }
+            for (int c = 0; c < 3; ++c) out[i][c] = static_cast<unsigned char>(((64 - colorWeight) * e0[c] + colorWeight * e1[c] + 32) >> 6);
+            out[i][3] = static_cast<unsigned char>(((64 - alphaWeight) * e0[3] + alphaWeight * e1[3] + 32) >> 6);
+            if (rotation) std::swap(out[i][3], out[i][rotation - 1]);
+        }
+    }
+
+    // --- Fast encoders ---
+
+    // The 16 texels of block (bx, by) in the 8-bit encoding of `texelFormat`,
+    // texels past the right / bottom edge repeat the last column / row
+    void gatherBlock(const std::vector<vec3f>& pixels, int width, int height, int bx, int by, TexelFormat texelFormat,
+                     unsigned char out[16][4]) {
+        std::memset(out, 0, 16 * 4);
+        for (int j = 0; j < 4; ++j) {
+            int y = std::min(by * 4 + j, height - 1);
+            for (int i = 0; i < 4; ++i) {
+                int x = std::min(bx * 4 + i, width - 1);
+                encodeTexel(texelFormat, pixels[static_cast<size_t>(y) * width + x], out[j * 4 + i]);
+            }
+        }
+    }
+
+    inline uint16_t packRGB565(const int color[3]) {
+        return static_cast<uint16_t>((((color[0] * 31 + 127) / 255) << 11) | (((color[1] * 63 + 127) / 255) << 5) |
+                                     ((color[2] * 31 + 127) / 255));
+    }
+
+    // Endpoints from the block's bounding box, inset by 1/16 of its size against
+    // outliers; the diagonal follows the signs of the covariances with the widest
+    // channel.
+    void encodeColorBlock(const unsigned char texels[16][4], unsigned char* block) {
+        int minColor[3] = {255, 255, 255}, maxColor[3] = {0, 0, 0}, sum[3] = {0, 0, 0};
+        for (int i = 0; i < 16; ++i) {
+            for (int c = 0; c < 3; ++c) {
+                minColor[c] = std::min(minColor[c], static_cast<int>(texels[i][c]));
+                maxColor[c] = std::max(maxColor[c], static_cast<int>(texels[i][c]));
+                sum[c] += texels[i][c];
+            }
+        }
+        int widest = 0;
+        for (int c = 1; c < 3; ++c) {
+            if (maxColor[c] - minColor[c] > maxColor[widest] - minColor[widest]) widest = c;
+        }
+        int covariance[3] = {0, 0, 0}; // With the widest channel, in 16x units
+        for (int i = 0; i < 16; ++i) {
+            int reference = texels[i][widest] * 16 - sum[widest];
+            for (int c = 0; c < 3; ++c) covariance[c] += reference * (texels[i][c] * 16 - sum[c]) / 256;
+        }
+
+        int endpoint0[3], endpoint1[3];
+        for (int c = 0; c < 3; ++c) {
+            int inset = (maxColor[c] - minColor[c]) >> 4;
+            int high = maxColor[c] - inset, low = minColor[c] + inset;
+            bool flipped = covariance[c] < 0;
+            endpoint0[c] = flipped ? low : high;
+            endpoint1[c] = flipped ? high : low;
+        }
+        uint16_t c0 = packRGB565(endpoint0), c1 = packRGB565(endpoint1);
+        if (c0 < c1) std::swap(c0, c1); // c0 > c1 selects the four color mode
+        block[0] = static_cast<unsigned char>(c0 & 0xFF);
+        block[1] = static_cast<unsigned char>(c0 >> 8);
+        block[2] = static_cast<unsigned char>(c1 & 0xFF);
+        block[3] = static_cast<unsigned char>(c1 >> 8);
+
+        uint32_t lookup = 0;
+        if (c0 != c1) { // Otherwise a solid block: every index 0
+            // Nearest palette entry by projecting onto the decoded endpoint axis;
+            // steps 0..3 from c1 to c0 are entries 1, 3, 2, 0
+            uint32_t palette[4];
+            colorPalette(block, false, palette);
+            unsigned char entries[4][4];
+            std::memcpy(entries, palette, sizeof(entries));
+            int axis[3], base = 0, axisLength = 0;
+            for (int c = 0; c < 3; ++c) {
+                axis[c] = entries[0][c] - entries[1][c];
+                base += entries[1][c] * axis[c];
+                axisLength += axis[c] * axis[c];
+            }
+            constexpr uint32_t stepToIndex[4] = {1, 3, 2, 0};
+            float scale = 3.0f / static_cast<float>(std::max(axisLength, 1));
+            for (int i = 0; i < 16; ++i) {
+                int projection = texels[i][0] * axis[0] + texels[i][1] * axis[1] + texels[i][2] * axis[2] - base;
+                int step = std::clamp(static_cast<int>(projection * scale + 0.5f), 0, 3);
+                lookup |= stepToIndex[step] << (2 * i);
+            }
+        }
+        for (int k = 0; k < 4; ++k) block[4 + k] = static_cast<unsigned char>(lookup >> (8 * k));
+    }
+
+    // Eight value mode between the block's min and max, nearest step per texel
+    void encodeChannelBlock(const unsigned char texels[16][4], int channel, unsigned char* block) {
+        int low = 255, high = 0;
+        for (int i = 0; i < 16; ++i) {
+            low = std::min(low, static_cast<int>(texels[i][channel]));
+            high = std::max(high, static_cast<int>(texels[i][channel]));
+        }
+        block[0] = static_cast<unsigned char>(high);
+        block[1] = static_cast<unsigned char>(low);
+
+        uint64_t lookup = 0;
+        if (high > low) { // Otherwise every index 0
+            int range = high - low;
+            for (int i = 0; i < 16; ++i) {
+                int step = ((texels[i][channel] - low) * 14 + range) / (2 * range); // 0 (low) .. 7 (high)
+                int index = step == 7 ? 0 : (step == 0 ? 1 : 8 - step);
+                lookup |= static_cast<uint64_t>(index) << (3 * i);
+            }
+        }
+        for (int k = 0; k < 6; ++k) block[2 + k] = static_cast<unsigned char>(lookup >> (8 * k));
+    }
+
+} // end anonymous namespace
+
+void decodeBlockRGBA8(TexelFormat format, const unsigned char* block, unsigned char out[16][4]) {
+    switch (format) {
+        case TexelFormat::BC1:
+            decodeColorBlock(block, true, out);
+            break;
+        case TexelFormat::BC3: {
+            decodeColorBlock(block + 8, false, out);
+#ifdef NaiveMethod
+            decodeChannelBlock(block, out, 3);
+#else
+            // Alpha bytes moved to the top byte of each texel
+            __m128i alpha = decodeChannelValues(block);
+            __m128i zero = _mm_setzero_si128();
+            __m128i alphaLow = _mm_unpacklo_epi8(zero, alpha), alphaHigh = _mm_unpackhi_epi8(zero, alpha);
+            __m128i alpha32[4] = { _mm_unpacklo_epi16(zero, alphaLow), _mm_unpackhi_epi16(zero, alphaLow),
+                                   _mm_unpacklo_epi16(zero, alphaHigh), _mm_unpackhi_epi16(zero, alphaHigh) };
+            const __m128i rgbMask = _mm_set1_epi32(0x00FFFFFF);
+            for (int row = 0; row < 4; ++row) {
+                __m128i* texels = reinterpret_cast<__m128i*>(out[4 * row]);
+                _mm_storeu_si128(texels, _mm_or_si128(_mm_and_si128(_mm_loadu_si128(texels), rgbMask), alpha32[row]));
+            }
+#endif
+            break;
+        }
+        case TexelFormat::BC4: {
+#ifdef NaiveMethod
+            decodeChannelBlock(block, out, 0);
+            for (int i = 0; i < 16; ++i) {
+                out[i][1] = out[i][2] = out[i][0];
+                out[i][3] = 255;
+            }
+#else
+            __m128i red = decodeChannelValues(block);
+            __m128i redAlpha = _mm_set1_epi8(static_cast<char>(0xFF));
+            storeTexels(_mm_unpacklo_epi8(red, red), _mm_unpackhi_epi8(red, red),
+                        _mm_unpacklo_epi8(red, redAlpha), _mm_unpackhi_epi8(red, redAlpha), out);
+#endif
+            break;
+        }
+        case TexelFormat::BC5: {
+#ifdef NaiveMethod
+            for (int i = 0; i < 16; ++i) {
+                out[i][2] = 0;
+                out[i][3] = 255;
+            }
+            decodeChannelBlock(block, out, 0);
+            decodeChannelBlock(block + 8, out, 1);
+#else
+            __m128i red = decodeChannelValues(block);
+            __m128i green = decodeChannelValues(block + 8);
+            __m128i blueAlpha = _mm_set1_epi16(static_cast<short>(0xFF00)); // b = 0, a = 255
+            storeTexels(_mm_unpacklo_epi8(red, green), _mm_unpackhi_epi8(red, green), blueAlpha, blueAlpha, out);
+#endif
+            break;
+        }
+        case TexelFormat::BC7:
+            decodeBC7Block(block, out);
+            break;
+        default: // Not a block format: magenta, like the samplers' error color
+            for (int i = 0; i < 16; ++i) {
+                out[i][0] = 255; out[i][1] = 0; out[i][2] = 255; out[i][3] = 255;
+            }
+            break;
+    }
+}
+
+void decodeBlockLevelRGBA8(TexelFormat format, const unsigned char* blocks, int width, int height, unsigned char* out, ThreadPool* pool) {
+    const int blocksWide = (width + 3) / 4;
+    const int blocksHigh = (height + 3) / 4;
+    const size_t blockBytes = static_cast<size_t>(bytesPerBlock(format));
+    auto decodeRows = [&](int begin, int end) {
+        for (int by = begin; by < end; ++by) {
+            for (int bx = 0; bx < blocksWide; ++bx) {
+                size_t block = static_cast<size_t>(by) * blocksWide + bx;
+                decodeBlockRGBA8(format, blocks + block * blockBytes, reinterpret_cast<unsigned char(*)[4]>(out + block * 64));
+            }
+        }
+    };
+    if (pool) pool->parallelFor(blocksHigh, 4, decodeRows);
+    else decodeRows(0, blocksHigh);
+}
+
+std::vector<unsigned char> encodeBlockLevel(TexelFormat format, const std::vector<vec3f>& pixels, int width, int height, ThreadPool* pool) {
+    const int blocksWide = (width + 3) / 4;
+    const int blocksHigh = (height + 3) / 4;
+    const size_t blockBytes = static_cast<size_t>(bytesPerBlock(format));
+    std::vector<unsigned char> blocks(blockLevelSize(format, width, height));
+    TexelFormat texelFormat = format == TexelFormat::BC1 ? TexelFormat::RGBA8 : (format == TexelFormat::BC5 ? TexelFormat::RG8 : TexelFormat::R8);
+    auto encodeRows = [&](int begin, int end) {
+        unsigned char texels[16][4];
+        for (int by = begin; by < end; ++by) {
+            for (int bx = 0; bx < blocksWide; ++bx) {
+                unsigned char* block = blocks.data() + (static_cast<size_t>(by) * blocksWide + bx) * blockBytes;
+                gatherBlock(pixels, width, height, bx, by, texelFormat, texels);
+                if (format == TexelFormat::BC1) {
+                    encodeColorBlock(texels, block);
+                } else {
+                    encodeChannelBlock(texels, 0, block);
+                    if (format == TexelFormat::BC5) encodeChannelBlock(texels, 1, block + 8);
+                }
+            }
+        }
+    };
+    if (pool) pool->parallelFor(blocksHigh, 4, encodeRows);
+    else encodeRows(0, blocksHigh);
+    return blocks;
+}
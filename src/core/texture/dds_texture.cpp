@@ -1,171 +1,20 @@
 #include "core/texture/dds_texture.h"
+#include "core/texture/block_compression.h"
+#include <chrono>
 #include <fstream>
 #include <cstring>
 #include <algorithm>
 
 namespace { // Anonymous namespace for internal linkage helper functions
 
-    // --- DDS Decompression Block Decoders ---
-    void decodeDXT1Block(const unsigned char* block, vec3f colors[4], uint32_t& lookup) {
-        uint16_t c0_16 = block[0] | (block[1] << 8);
-        uint16_t c1_16 = block[2] | (block[3] << 8);
-        lookup = block[4] | (block[5] << 8) | (block[6] << 16) | (block[7] << 24);
-    
-        colors[0] = { ((c0_16 >> 11) & 31) / 31.0f, ((c0_16 >> 5) & 63) / 63.0f, (c0_16 & 31) / 31.0f };
-        colors[1] = { ((c1_16 >> 11) & 31) / 31.0f, ((c1_16 >> 5) & 63) / 63.0f, (c1_16 & 31) / 31.0f };
-    
-        if (c0_16 > c1_16) {
-            colors[2] = (colors[0] * 2.0f + colors[1]) / 3.0f;
-            colors[3] = (colors[0] + colors[1] * 2.0f) / 3.0f;
-        } else {
-            colors[2] = (colors[0] + colors[1]) / 2.0f;
-            colors[3] = vec3f(0.0f, 0.0f, 0.0f); // Transparent black
-        }
-    }
-    
-    void decodeDXT5Block(const unsigned char* block, vec3f colors[4], float alphas[8], uint32_t& colorLookup, uint64_t& alphaLookup) {
-        alphas[0] = block[0] / 255.0f;
-        alphas[1] = block[1] / 255.0f;
-        alphaLookup = 0;
-        for (int i = 0; i < 6; ++i) alphaLookup |= (uint64_t)block[2 + i] << (i * 8);
-    
-        if (block[0] > block[1]) {
-            for (int i = 0; i < 6; ++i) alphas[i + 2] = ((6 - i) * block[0] + (i + 1) * block[1]) / 7.0f / 255.0f;
-        } else {
-            for (int i = 0; i < 4; ++i) alphas[i + 2] = ((4 - i) * block[0] + (i + 1) * block[1]) / 5.0f / 255.0f;
-            alphas[6] = 0.0f; alphas[7] = 1.0f;
-        }
-        decodeDXT1Block(block + 8, colors, colorLookup); // Color part is DXT1
+    // Texel (x, y) of a level decoded in block order (decodeBlockLevelRGBA8)
+    inline size_t blockOrderIndex(int x, int y, int blocksWide) {
+        return (static_cast<size_t>(y >> 2) * blocksWide + (x >> 2)) * 16 + ((y & 3) << 2) + (x & 3);
     }
-    
-    void decodeATI2Block(const unsigned char* block, float reds[8], float greens[8], uint64_t& rLookup, uint64_t& gLookup) {
-        // Red channel block (first 8 bytes) - DXT5 alpha style
-        reds[0] = block[0] / 255.0f; reds[1] = block[1] / 255.0f; rLookup = 0;
-        for (int i = 0; i < 6; ++i) rLookup |= (uint64_t)block[2 + i] << (i * 8);
-        if (block[0] > block[1]) { for (int i = 0; i < 6; ++i) reds[i + 2] = ((6 - i) * block[0] + (i + 1) * block[1]) / 7.0f / 255.0f; }
-        else { for (int i = 0; i < 4; ++i) reds[i + 2] = ((4 - i) * block[0] + (i + 1) * block[1]) / 5.0f / 255.0f; reds[6] = 0.0f; reds[7] = 1.0f; }
-    
-        // Green channel block (next 8 bytes) - DXT5 alpha style
-        greens[0] = block[8] / 255.0f; greens[1] = block[9] / 255.0f; gLookup = 0;
-        for (int i = 0; i < 6; ++i) gLookup |= (uint64_t)block[10 + i] << (i * 8);
-        if (block[8] > block[9]) { for (int i = 0; i < 6; ++i) greens[i + 2] = ((6 - i) * block[8] + (i + 1) * block[9]) / 7.0f / 255.0f; }
-        else { for (int i = 0; i < 4; ++i) greens[i + 2] = ((4 - i) * block[8] + (i + 1) * block[9]) / 5.0f / 255.0f; greens[6] = 0.0f; greens[7] = 1.0f; }
-    }
-    
-    // --- Per-Level Decompressors ---
-    
-    bool decompressDXT1LevelInternal(const std::vector<unsigned char>& data, int levelWidth, int levelHeight, std::vector<vec3f>& outPixels) {
-        outPixels.resize(levelWidth * levelHeight);
-        uint32_t blocksWide = (levelWidth + 3) / 4;
-        uint32_t blocksHigh = (levelHeight + 3) / 4;
-        size_t expectedDataSize = blocksWide * blocksHigh * 8;
-        if (data.size() < expectedDataSize) {
-             std::cerr << "DXT1 data size mismatch for level " << levelWidth << "x" << levelHeight << ". Expected " << expectedDataSize << ", Got " << data.size() << std::endl;
-             return false;
-        }
-    
-        size_t blockOffset = 0;
-        for (uint32_t y = 0; y < blocksHigh; ++y) {
-            for (uint32_t x = 0; x < blocksWide; ++x) {
-                const unsigned char* block = data.data() + blockOffset;
-                vec3f colors[4];
-                uint32_t lookup;
-                decodeDXT1Block(block, colors, lookup);
-
-                for (int j = 0; j < 4; ++j) { // Pixel y within block
-                    int py = y * 4 + j;
-                    if (py >= levelHeight) continue;
-                    for (int i = 0; i < 4; ++i) { // Pixel x within block
-                        int px = x * 4 + i;
-                        if (px >= levelWidth) continue;
-                        int index = (lookup >> (2 * (j * 4 + i))) & 0x3;
-                        outPixels[py * levelWidth + px] = colors[index];
-                    }
-                }
-                blockOffset += 8;
-            }
-        }
-        return true;
-    }
-    
-    bool decompressDXT5LevelInternal(const std::vector<unsigned char>& data, int levelWidth, int levelHeight, std::vector<vec3f>& outPixels) {
-        outPixels.resize(levelWidth * levelHeight);
-        uint32_t blocksWide = (levelWidth + 3) / 4;
-        uint32_t blocksHigh = (levelHeight + 3) / 4;
-        size_t expectedDataSize = blocksWide * blocksHigh * 16;
-        if (data.size() < expectedDataSize) {
-            std::cerr << "DXT5 data size mismatch for level " << levelWidth << "x" << levelHeight << ". Expected " << expectedDataSize << ", Got " << data.size() << std::endl;
-            return false;
-        }
-    
-        size_t blockOffset = 0;
-        for (uint32_t y = 0; y < blocksHigh; ++y) {
-            for (uint32_t x = 0; x < blocksWide; ++x) {
-                const unsigned char* block = data.data() + blockOffset;
-                vec3f colors[4];
-                float alphas[8];
-                uint32_t colorLookup;
-                uint64_t alphaLookup;
-                decodeDXT5Block(block, colors, alphas, colorLookup, alphaLookup);
-    
-                for (int j = 0; j < 4; ++j) {
-                    int py = y * 4 + j;
-                    if (py >= levelHeight) continue;
-                    for (int i = 0; i < 4; ++i) {
-                        int px = x * 4 + i;
-                        if (px >= levelWidth) continue;
-                        int colorIndex = (colorLookup >> (2 * (j * 4 + i))) & 0x3;
-                        // int alphaIndex = (alphaLookup >> (3 * (j * 4 + i))) & 0x7; // If needed
-                        outPixels[py * levelWidth + px] = colors[colorIndex]; // Store only RGB for now
-                    }
-                }
-                 blockOffset += 16;
-            }
-        }
-        return true;
-    }
-    
-    bool decompressATI2LevelInternal(const std::vector<unsigned char>& data, int levelWidth, int levelHeight, std::vector<vec3f>& outPixels) {
-        outPixels.resize(levelWidth * levelHeight);
-        uint32_t blocksWide = (levelWidth + 3) / 4;
-        uint32_t blocksHigh = (levelHeight + 3) / 4;
-        size_t expectedDataSize = blocksWide * blocksHigh * 16;
-        if (data.size() < expectedDataSize) {
-             std::cerr << "ATI2 data size mismatch for level " << levelWidth << "x" << levelHeight << ". Expected " << expectedDataSize << ", Got " << data.size() << std::endl;
-             return false;
-        }
-    
-        size_t blockOffset = 0;
-        for (uint32_t y = 0; y < blocksHigh; ++y) {
-            for (uint32_t x = 0; x < blocksWide; ++x) {
-                const unsigned char* block = data.data() + blockOffset;
-                float reds[8], greens[8];
-                uint64_t rLookup, gLookup;
-                decodeATI2Block(block, reds, greens, rLookup, gLookup);
-
-                for (int j = 0; j < 4; ++j) {
-                    int py = y * 4 + j;
-                    if (py >= levelHeight) continue;
-                    for (int i = 0; i < 4; ++i) {
-                        int px = x * 4 + i;
-                        if (px >= levelWidth) continue;
-                        int rIndex = (rLookup >> (3 * (j * 4 + i))) & 0x7;
-                        int gIndex = (gLookup >> (3 * (j * 4 + i))) & 0x7;
-                        float r = reds[rIndex];
-                        float g = greens[gIndex];
-                        float b = std::sqrt(std::max(0.0f, 1.0f - r * r - g * g)); // Reconstruct B
-                        outPixels[py * levelWidth + px] = vec3f(r, g, b);
-                    }
-                }
-                blockOffset += 16;
-            }
-        }
-        return true;
-    }
-    
+
 } // end anonymous namespace
-    
-bool DDSTexture::readHeader(std::ifstream& file, DDSHeader& header, std::string& outError) {
+
+bool DDSTexture::readHeader(std::ifstream& file, DDSHeader& header, DDSHeaderDXT10& dx10, std::string& outError) {
     if (!file.is_open() || !file.good()) {
         outError = "File stream is not open or in a bad state.";
         return false;
@@ -198,32 +47,92 @@ bool DDSTexture::readHeader(std::ifstream& file, DDSHeader& header, std::string&
     }
 
 
-    // Optional: Check for DX10 header if FourCC is "DX10"
-    // This example does not handle the DX10 extension.
+    dx10 = {};
+    if ((header.pixelFormat.flags & DDPF_FOURCC) && strncmp(header.pixelFormat.fourCC, "DX10", 4) == 0) {
+        file.read(reinterpret_cast<char*>(&dx10), sizeof(DDSHeaderDXT10));
+        if (!file) {
+            outError = "Truncated DX10 header extension.";
+            return false;
+        }
+    }
 
     outError = "";
     return true;
 }
 
-bool DDSTexture::decompressDXT1(const std::vector<unsigned char>& data, int w, int h) {
-    if(mipLevels.empty()) mipLevels.resize(1); // Ensure base level exists
-    mipLevels[0].width = w;
-    mipLevels[0].height = h;
-    return decompressDXT1LevelInternal(data, w, h, mipLevels[0].pixels);
+bool DDSTexture::blockFormatOf(const DDSHeader& header, const DDSHeaderDXT10& dx10, TexelFormat& outFormat, std::string& outName) {
+    if (!(header.pixelFormat.flags & DDPF_FOURCC)) return false;
+    const char* fourCC = header.pixelFormat.fourCC;
+    if (strncmp(fourCC, "DX10", 4) == 0) {
+        switch (dx10.dxgiFormat) {
+            case DXGI_FORMAT_BC1_TYPELESS: case DXGI_FORMAT_BC1_UNORM: case DXGI_FORMAT_BC1_UNORM_SRGB:
+                outFormat = TexelFormat::BC1; break;
+            case DXGI_FORMAT_BC3_TYPELESS: case DXGI_FORMAT_BC3_UNORM: case DXGI_FORMAT_BC3_UNORM_SRGB:
+                outFormat = TexelFormat::BC3; break;
+            case DXGI_FORMAT_BC4_TYPELESS: case DXGI_FORMAT_BC4_UNORM:
+                outFormat = TexelFormat::BC4; break;
+            case DXGI_FORMAT_BC5_TYPELESS: case DXGI_FORMAT_BC5_UNORM:
+                outFormat = TexelFormat::BC5; break;
+            case DXGI_FORMAT_BC7_TYPELESS: case DXGI_FORMAT_BC7_UNORM: case DXGI_FORMAT_BC7_UNORM_SRGB:
+                outFormat = TexelFormat::BC7; break;
+            default: // BC2, the signed BC4/BC5 variants, BC6H and uncompressed DXGI formats
+                outName = "DXGI " + std::to_string(dx10.dxgiFormat);
+                return false;
+        }
+        outName = texelFormatName(outFormat);
+        return true;
+    }
+    if (strncmp(fourCC, "DXT1", 4) == 0) { outFormat = TexelFormat::BC1; outName = "DXT1"; }
+    else if (strncmp(fourCC, "DXT5", 4) == 0) { outFormat = TexelFormat::BC3; outName = "DXT5"; }
+    else if (strncmp(fourCC, "ATI1", 4) == 0 || strncmp(fourCC, "BC4U", 4) == 0) { outFormat = TexelFormat::BC4; outName = "ATI1/BC4"; }
+    else if (strncmp(fourCC, "ATI2", 4) == 0 || strncmp(fourCC, "BC5U", 4) == 0) { outFormat = TexelFormat::BC5; outName = "ATI2/BC5"; }
+    else {
+        outName = std::string(fourCC, 4);
+        return false;
+    }
+    return true;
 }
 
-bool DDSTexture::decompressDXT5(const std::vector<unsigned char>& data, int w, int h) {
-    if(mipLevels.empty()) mipLevels.resize(1);
-    mipLevels[0].width = w;
-    mipLevels[0].height = h;
-    return decompressDXT5LevelInternal(data, w, h, mipLevels[0].pixels);
-}
+void DDSTexture::storeDecodedLevel(std::vector<unsigned char>&& decoded, TexelFormat blockFormat, TexelFormat storageFormat,
+                                   int width, int height, MipLevel& outLevel) const {
+    const int blocksWide = (width + 3) / 4;
+    if (storageFormat == TexelFormat::RGBA8) {
+        outLevel.width = width;
+        outLevel.height = height;
+        outLevel.format = TexelFormat::RGBA8;
+        outLevel.layout = options.layout;
+        if (options.layout == TexelLayout::Tiled4x4) {
+            outLevel.data = std::move(decoded); // Block order already is the tiled layout
+            return;
+        }
+        std::vector<unsigned char> linear(static_cast<size_t>(width) * height * 4);
+        for (int y = 0; y < height; ++y) {
+            for (int x = 0; x < width; x += 4) {
+                std::memcpy(linear.data() + (static_cast<size_t>(y) * width + x) * 4, decoded.data() + blockOrderIndex(x, y, blocksWide) * 4,
+                            static_cast<size_t>(std::min(4, width - x)) * 4);
+            }
+        }
+        outLevel.data = std::move(linear);
+        return;
+    }
 
-bool DDSTexture::decompressATI2(const std::vector<unsigned char>& data, int w, int h) {
-    if(mipLevels.empty()) mipLevels.resize(1);
-    mipLevels[0].width = w;
-    mipLevels[0].height = h;
-    return decompressATI2LevelInternal(data, w, h, mipLevels[0].pixels);
+    // Two-channel normals and R8 go through the float encoder
+    const float inv255 = 1.0f / 255.0f;
+    std::vector<vec3f> pixels(static_cast<size_t>(width) * height);
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            const unsigned char* texel = decoded.data() + blockOrderIndex(x, y, blocksWide) * 4;
+            vec3f& pixel = pixels[static_cast<size_t>(y) * width + x];
+            if (blockFormat == TexelFormat::BC5) {
+                pixel = decodeNormalXY(texel[0] * inv255, texel[1] * inv255); // Signed normal with reconstructed Z
+            } else {
+                pixel = vec3f(texel[0] * inv255, texel[1] * inv255, texel[2] * inv255);
+                if (storageFormat == TexelFormat::RG8) pixel = colorToNormal(pixel); // Also renormalizes the stored mips
+            }
+        }
+    }
+    decoded = std::vector<unsigned char>();
+    encodeLevel(pixels, width, height, storageFormat, outLevel, options.layout);
 }
 
 
@@ -235,8 +144,9 @@ bool DDSTexture::load(const std::string& filename) {
     }
 
     DDSHeader header;
+    DDSHeaderDXT10 dx10;
     std::string error;
-    if (!readHeader(file, header, error)) {
+    if (!readHeader(file, header, dx10, error)) {
         std::cerr << "Error reading DDS header for " << filename << ": " << error << std::endl;
         return false;
     }
@@ -244,25 +154,22 @@ bool DDSTexture::load(const std::string& filename) {
     int baseWidth = header.width;
     int baseHeight = header.height;
 
-    // Determine compression type and block size
-    bool isDXT1 = false, isDXT5 = false, isATI2 = false;
-    uint32_t blockSize = 0; // Bytes per 4x4 block
-
+    // Determine the block format
+    TexelFormat blockFormat;
     if (header.pixelFormat.flags & DDPF_FOURCC) {
-        // Check for DX10 header if necessary
-        if (strncmp(header.pixelFormat.fourCC, "DX10", 4) == 0) {
-            std::cerr << "Error: DX10 DDS header extension not supported in " << filename << std::endl;
-            return false; // Add DX10 support later if needed
-        }
-        // Standard FourCC formats
-        else if (strncmp(header.pixelFormat.fourCC, "DXT1", 4) == 0) { isDXT1 = true; blockSize = 8; compressionFormat = "DXT1"; }
-        else if (strncmp(header.pixelFormat.fourCC, "DXT5", 4) == 0) { isDXT5 = true; blockSize = 16; compressionFormat = "DXT5"; }
-        else if (strncmp(header.pixelFormat.fourCC, "ATI2", 4) == 0 || strncmp(header.pixelFormat.fourCC, "BC5U", 4) == 0) { isATI2 = true; blockSize = 16; compressionFormat = "ATI2/BC5"; }
-        // Add other FourCC checks (DXT2/3/4, BC4, etc.) if needed
-        else {
-            std::cerr << "Unsupported DDS FourCC format: " << std::string(header.pixelFormat.fourCC, 4) << " in " << filename << std::endl;
+        if (!blockFormatOf(header, dx10, blockFormat, compressionFormat)) {
+            std::cerr << "Unsupported DDS format: " << compressionFormat << " in " << filename << std::endl;
             return false;
         }
+        if (strncmp(header.pixelFormat.fourCC, "DX10", 4) == 0) {
+            if (dx10.resourceDimension != DDS_DIMENSION_TEXTURE2D) {
+                std::cerr << "Error: DX10 DDS resource is not a 2D texture in " << filename << std::endl;
+                return false;
+            }
+            if (dx10.arraySize > 1 || (dx10.miscFlag & 0x4)) { // Array or cube map: the first slice's chain comes first
+                std::cerr << "Warning: Only the first slice of " << filename << " is loaded" << std::endl;
+            }
+        }
         isCompressed = true;
     } else {
         // Handle uncompressed formats if needed (checking rgbBitCount, masks)
@@ -285,6 +192,14 @@ bool DDSTexture::load(const std::string& filename) {
 
     mipLevels.resize(numLevels);
 
+    // Storage format: two-channel data stays two-channel, everything else follows the usage
+    // (normal maps become two-channel too, see isTwoChannelNormal; BC4 scalar maps become R8)
+    TexelFormat storageFormat = blockFormat == TexelFormat::BC5 ? TexelFormat::RG8 : defaultFormatForUsage(options.usage);
+    if (storageFormat == TexelFormat::RGBA16F) storageFormat = TexelFormat::RGBA8; // Block data is 8-bit anyway
+    // Or keep the blocks as they are and decode on fetch (options.keepCompressed)
+    double decodeMs = 0.0;
+    size_t decodedBytes = 0;
+
     // Load each mip level
     int currentWidth = baseWidth;
     int currentHeight = baseHeight;
@@ -297,21 +212,9 @@ bool DDSTexture::load(const std::string& filename) {
              break;
         }
 
-        mipLevels[level].width = currentWidth;
-        mipLevels[level].height = currentHeight;
-
-        uint32_t levelWidthBlocks = (currentWidth + 3) / 4;
-        uint32_t levelHeightBlocks = (currentHeight + 3) / 4;
-        uint32_t dataSize = levelWidthBlocks * levelHeightBlocks * blockSize;
-
-        if (dataSize == 0) {
-             std::cerr << "Warning: Zero data size calculated for mip level " << level << " in " << filename << ". Stopping load." << std::endl;
-             mipLevels.resize(level);
-             break;
-        }
-
+        size_t dataSize = blockLevelSize(blockFormat, currentWidth, currentHeight);
         std::vector<unsigned char> compressedData(dataSize);
-        file.read(reinterpret_cast<char*>(compressedData.data()), dataSize);
+        file.read(reinterpret_cast<char*>(compressedData.data()), static_cast<std::streamsize>(dataSize));
 
         if (!file) {
             std::cerr << "Error reading data for mip level " << level << " (size " << dataSize << ") in " << filename << ". Read " << file.gcount() << " bytes."<< std::endl;
@@ -319,16 +222,16 @@ bool DDSTexture::load(const std::string& filename) {
             return false;
         }
 
-        // Decompress this level using internal helper functions
-        bool success = false;
-        if (isDXT1) success = decompressDXT1LevelInternal(compressedData, currentWidth, currentHeight, mipLevels[level].pixels);
-        else if (isDXT5) success = decompressDXT5LevelInternal(compressedData, currentWidth, currentHeight, mipLevels[level].pixels);
-        else if (isATI2) success = decompressATI2LevelInternal(compressedData, currentWidth, currentHeight, mipLevels[level].pixels);
-
-        if (!success) {
-            std::cerr << "Error decompressing mip level " << level << " in " << filename << std::endl;
-            mipLevels.clear();
-            return false;
+        if (options.keepCompressed) {
+            storeBlockLevel(std::move(compressedData), currentWidth, currentHeight, blockFormat, mipLevels[level]);
+        } else {
+            // Decode the whole level into RGBA8 blocks (rows of blocks in parallel on the workers)
+            auto decodeStart = std::chrono::high_resolution_clock::now();
+            std::vector<unsigned char> decoded(dataSize / bytesPerBlock(blockFormat) * 64);
+            decodeBlockLevelRGBA8(blockFormat, compressedData.data(), currentWidth, currentHeight, decoded.data(), workers);
+            decodeMs += std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - decodeStart).count();
+            decodedBytes += decoded.size();
+            storeDecodedLevel(std::move(decoded), blockFormat, storageFormat, currentWidth, currentHeight, mipLevels[level]);
         }
 
         // Calculate dimensions for the next level
@@ -337,11 +240,16 @@ bool DDSTexture::load(const std::string& filename) {
     }
 
     // Check if we actually loaded any levels
-    if (mipLevels.empty() || mipLevels[0].pixels.empty()) {
+    if (mipLevels.empty() || mipLevels[0].data.empty()) {
         std::cerr << "Error: No valid mip levels loaded for " << filename << std::endl;
         return false;
     }
 
+    if (decodedBytes > 0) {
+        double megabytes = decodedBytes / (1024.0 * 1024.0);
+        std::cout << "Decoded " << compressionFormat << ": " << megabytes << " MB in " << decodeMs << " ms ("
+                  << (decodeMs > 0.0 ? megabytes * 1000.0 / decodeMs : 0.0) << " MB/s)" << std::endl;
+    }
     return true; // Successfully loaded
 }
 
@@ -355,14 +263,15 @@ bool DDSTexture::getCompressionFormat(const std::string& filename, std::string&
     }
 
     DDSHeader header;
-    if (!readHeader(file, header, outError)) { // Use static readHeader
+    DDSHeaderDXT10 dx10;
+    if (!readHeader(file, header, dx10, outError)) { // Use static readHeader
         outFormat = "Unknown";
         return false; // Error already set by readHeader
     }
 
     if (header.pixelFormat.flags & DDPF_FOURCC) {
-        outFormat = std::string(header.pixelFormat.fourCC, 4);
-        // Handle DX10 case if needed: check if outFormat == "DX10", read DX10 header, determine specific format
+        TexelFormat format;
+        blockFormatOf(header, dx10, format, outFormat); // Names unsupported formats too (FourCC or DXGI value)
     } else if (header.pixelFormat.flags & DDPF_RGB) {
          outFormat = "Uncompressed RGB"; // Could add bit depth info
     } else if (header.pixelFormat.flags & DDPF_LUMINANCE) {
@@ -377,46 +286,3 @@ bool DDSTexture::getCompressionFormat(const std::string& filename, std::string&
     outError = "";
     return true;
 }
-
-
-// Accurate sampling function using derivatives
-vec3f DDSTexture::sample(float u, float v, const vec2f& ddx, const vec2f& ddy) const {
-    if (mipLevels.empty() || mipLevels[0].pixels.empty()) {
-        return vec3f(1.0f, 0.0f, 1.0f); // Magenta error color
-    }
-
-    const auto& baseLevel = mipLevels[0];
-    float baseWidth = static_cast<float>(baseLevel.width);
-    float baseHeight = static_cast<float>(baseLevel.height);
-
-    // Calculate rho squared
-    float rho_sq = std::max(ddx.lengthSq() * baseWidth * baseWidth,
-                            ddy.lengthSq() * baseHeight * baseHeight);
-
-    // Calculate LOD level
-    float lod = 0.0f;
-    if (rho_sq > 1e-9f) { // Use a small epsilon to avoid log(0)
-        lod = 0.5f * std::log2(rho_sq);
-    }
-    
-    lod = std::max(0.0f, lod); // Clamp LOD >= 0
-
-    // Determine levels and interpolation factor
-    int maxLevel = static_cast<int>(mipLevels.size()) - 1;
-    int level0_idx = static_cast<int>(std::floor(lod));
-    level0_idx = std::min(level0_idx, maxLevel);
-
-    vec3f color0 = sampleBilinear(mipLevels[level0_idx], u, v);
-
-    if (level0_idx == maxLevel) {
-        return color0; // Only one level needed
-    }
-
-    int level1_idx = level0_idx + 1;
-    vec3f color1 = sampleBilinear(mipLevels[level1_idx], u, v);
-
-    float level_t = lod - static_cast<float>(level0_idx);
-
-    // Trilinear interpolation
-    return color0 * (1.0f - level_t) + color1 * level_t;
-}
\ No newline at end of file
@@ -0,0 +1,55 @@
+// src/core/texture/material_sampler.cpp
+#include "core/texture/material_sampler.h"
+
+float MaterialSampler::lodFor(int width, int height) {
+    for (int i = 0; i < numLods; ++i) {
+        if (lods[i].width == width && lods[i].height == height) return lods[i].lod;
+    }
+    float lod = Texture::lodForSize(ddx, ddy, width, height);
+    if (numLods < MaxEntries) lods[numLods++] = { width, height, lod };
+    return lod;
+}
+
+const Texture::TexelFootprint& MaterialSampler::footprintFor(const Texture::MipLevel& level) {
+    for (int i = 0; i < numFootprints; ++i) {
+        if (footprints[i].width == level.width && footprints[i].height == level.height) return footprints[i].footprint;
+    }
+    if (numFootprints < MaxEntries) {
+        FootprintEntry& entry = footprints[numFootprints++];
+        entry = { level.width, level.height, Texture::computeFootprint(level, u, v) };
+        return entry.footprint;
+    }
+    scratch = Texture::computeFootprint(level, u, v);
+    return scratch;
+}
+
+vec3f MaterialSampler::sample(const Texture& texture) {
+    if (texture.mipLevels.empty() || texture.mipLevels[0].width <= 0 || texture.mipLevels[0].height <= 0) {
+        return vec3f(1.0f, 0.0f, 1.0f); // Magenta error color
+    }
+
+    float lod = lodFor(texture.mipLevels[0].width, texture.mipLevels[0].height);
+    int maxLevel = static_cast<int>(texture.mipLevels.size()) - 1;
+    int level0_idx = std::min(static_cast<int>(lod), maxLevel);
+
+    const Texture::MipLevel& level0 = texture.mipLevels[level0_idx];
+    if (level0.data.empty()) {
+        // Texels not held in the level (virtual texture pages): let the texture decide
+        return texture.sample(u, v, ddx, ddy);
+    }
+    vec3f color0 = Texture::blendFootprint(level0, footprintFor(level0));
+
+    float level_t = lod - static_cast<float>(level0_idx);
+    if (level0_idx == maxLevel || level_t <= 0.0f) {
+        return color0;
+    }
+
+    const Texture::MipLevel& level1 = texture.mipLevels[level0_idx + 1];
+    if (level1.data.empty()) {
+        return texture.sample(u, v, ddx, ddy);
+    }
+    vec3f color1 = Texture::blendFootprint(level1, footprintFor(level1));
+
+    // Trilinear interpolation
+    return color0 * (1.0f - level_t) + color1 * level_t;
+}
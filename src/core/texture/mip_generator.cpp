@@ -0,0 +1,269 @@
+// src/core/texture/mip_generator.cpp
+#include "core/texture/mip_generator.h"
+#include "core/texture/texel_format.h"
+#include "core/threadpool.h"
+#include <cmath>
+#include <functional>
+
+namespace { // Anonymous namespace for internal linkage helper functions
+
+    constexpr float Pi = 3.14159265358979f;
+    constexpr float KaiserAlpha = 4.0f;
+    constexpr float KernelRadius = 3.0f; // Kaiser and Lanczos, in output texels
+
+    void forRows(ThreadPool* pool, int rows, const std::function<void(int, int)>& body) {
+        if (pool) pool->parallelFor(rows, 8, body);
+        else body(0, rows);
+    }
+
+    float sinc(float x) {
+        if (std::fabs(x) < 1e-6f) return 1.0f;
+        x *= Pi;
+        return std::sin(x) / x;
+    }
+
+    // Modified Bessel function of the first kind, order 0 (power series)
+    float besselI0(float x) {
+        float sum = 1.0f, term = 1.0f, halfX = 0.5f * x;
+        for (int k = 1; k < 32 && term > sum * 1e-8f; ++k) {
+            term *= (halfX / k) * (halfX / k);
+            sum += term;
+        }
+        return sum;
+    }
+
+    float filterWeight(MipFilter filter, float x) {
+        x = std::fabs(x);
+        if (x >= KernelRadius) return 0.0f;
+        if (filter == MipFilter::Kaiser) {
+            float t = x / KernelRadius;
+            return sinc(x) * besselI0(KaiserAlpha * std::sqrt(1.0f - t * t)) / besselI0(KaiserAlpha);
+        }
+        return sinc(x) * sinc(x / KernelRadius); // Lanczos
+    }
+
+    // Input texels and weights of every output texel along one axis,
+    // `taps` entries per output texel (unused entries have weight 0)
+    struct AxisTaps {
+        int taps = 0;
+        std::vector<int> first;  // Unwrapped input coordinate of the first tap
+        std::vector<int> index;  // Wrapped input coordinates
+        std::vector<float> weight;
+    };
+
+    AxisTaps buildAxisTaps(MipFilter filter, int inSize, int outSize) {
+        AxisTaps axis;
+        if (inSize == outSize) { // Axis already at 1 texel
+            axis.taps = 1;
+            axis.first.resize(outSize);
+            axis.index.resize(outSize);
+            axis.weight.assign(outSize, 1.0f);
+            for (int i = 0; i < outSize; ++i) axis.first[i] = axis.index[i] = i;
+            return axis;
+        }
+
+        // Input texel k covers [k, k + 1]; the kernel is stretched by the scale
+        float scale = static_cast<float>(inSize) / outSize;
+        float radius = (filter == MipFilter::Box ? 0.5f : KernelRadius) * scale;
+        axis.taps = 1;
+        for (int o = 0; o < outSize; ++o) { // Widest footprint, e.g. 2 for an even box
+            float center = (o + 0.5f) * scale;
+            axis.taps = std::max(axis.taps, static_cast<int>(std::ceil(center + radius)) - static_cast<int>(std::floor(center - radius)));
+        }
+        axis.first.resize(outSize);
+        axis.index.assign(static_cast<size_t>(outSize) * axis.taps, 0);
+        axis.weight.assign(static_cast<size_t>(outSize) * axis.taps, 0.0f);
+
+        for (int o = 0; o < outSize; ++o) {
+            float center = (o + 0.5f) * scale;
+            int first = static_cast<int>(std::floor(center - radius));
+            int last = std::min(static_cast<int>(std::ceil(center + radius)) - 1, first + axis.taps - 1);
+            axis.first[o] = first;
+            int* index = &axis.index[static_cast<size_t>(o) * axis.taps];
+            float* weight = &axis.weight[static_cast<size_t>(o) * axis.taps];
+
+            float sum = 0.0f;
+            for (int k = first; k <= last; ++k) {
+                float w;
+                if (filter == MipFilter::Box) { // Area of the texel inside the footprint
+                    w = std::max(0.0f, std::min(k + 1.0f, center + radius) - std::max(static_cast<float>(k), center - radius));
+                } else {
+                    w = filterWeight(filter, (k + 0.5f - center) / scale);
+                }
+                index[k - first] = ((k % inSize) + inSize) % inSize; // Wrap like the sampler
+                weight[k - first] = w;
+                sum += w;
+            }
+            if (std::fabs(sum) < 1e-8f) { // Degenerate kernel: nearest texel
+                std::fill(weight, weight + axis.taps, 0.0f);
+                axis.first[o] = index[0] = std::min(inSize - 1, static_cast<int>(center));
+                weight[0] = sum = 1.0f;
+            }
+            for (int t = 0; t < axis.taps; ++t) weight[t] /= sum;
+        }
+        return axis;
+    }
+
+    // dst[0, count) += w * src[0, count), count a multiple of 4
+    inline void maddRow(float* dst, const float* src, float w, size_t count) {
+#ifdef NaiveMethod
+        for (size_t i = 0; i < count; ++i) dst[i] += w * src[i];
+#else
+        __m128 wv = _mm_set1_ps(w);
+        for (size_t i = 0; i < count; i += 4) {
+            _mm_storeu_ps(dst + i, _mm_add_ps(_mm_loadu_ps(dst + i), _mm_mul_ps(wv, _mm_loadu_ps(src + i))));
+        }
+#endif
+    }
+
+    // Weighted sum of the texels of one row at the given indices; `Stride` floats per
+    // texel. With a stride of 3 the 4th lane reads the next texel and is ignored, so
+    // the row must not be the last one of the image.
+    template <int Stride>
+    inline void filterTexel(const float* row, const int* index, const float* weight, int taps, float* out) {
+#ifdef NaiveMethod
+        out[0] = out[1] = out[2] = out[3] = 0.0f;
+        for (int t = 0; t < taps; ++t) {
+            const float* texel = row + static_cast<size_t>(index[t]) * Stride;
+            for (int c = 0; c < 3; ++c) out[c] += weight[t] * texel[c];
+        }
+#else
+        __m128 sum = _mm_setzero_ps();
+        for (int t = 0; t < taps; ++t) {
+            sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(weight[t]), _mm_loadu_ps(row + static_cast<size_t>(index[t]) * Stride)));
+        }
+        _mm_storeu_ps(out, sum);
+#endif
+    }
+
+    // Finishes a filtered texel: unit length for normals, back to sRGB, or clamped
+    inline vec3f finishTexel(vec3f value, const MipGenerationSettings& settings);
+
+    // Exact 2:1 box on both axes: a plain 2x2 average, the common case
+    void downsampleBox2x2(const MipImage& src, MipImage& dst, const MipGenerationSettings& settings, int begin, int end) {
+        for (int y = begin; y < end; ++y) {
+            const float* row0 = &src.pixels[static_cast<size_t>(2 * y) * src.width].x;
+            const float* row1 = &src.pixels[static_cast<size_t>(2 * y + 1) * src.width].x;
+            vec3f* out = &dst.pixels[static_cast<size_t>(y) * dst.width];
+            int x = 0;
+#ifndef NaiveMethod
+            // The last texel of the image has no texel after it for a 4 float load
+            int simdWidth = (y == dst.height - 1) ? dst.width - 1 : dst.width;
+            const __m128 quarter = _mm_set1_ps(0.25f);
+            alignas(16) float texel[4];
+            for (; x < simdWidth; ++x) {
+                __m128 top = _mm_add_ps(_mm_loadu_ps(row0 + 6 * x), _mm_loadu_ps(row0 + 6 * x + 3));
+                __m128 bottom = _mm_add_ps(_mm_loadu_ps(row1 + 6 * x), _mm_loadu_ps(row1 + 6 * x + 3));
+                _mm_store_ps(texel, _mm_mul_ps(_mm_add_ps(top, bottom), quarter));
+                out[x] = finishTexel(vec3f(texel[0], texel[1], texel[2]), settings);
+            }
+#endif
+            for (; x < dst.width; ++x) {
+                const vec3f* p0 = reinterpret_cast<const vec3f*>(row0) + 2 * x;
+                const vec3f* p1 = reinterpret_cast<const vec3f*>(row1) + 2 * x;
+                out[x] = finishTexel((p0[0] + p0[1] + p1[0] + p1[1]) * 0.25f, settings);
+            }
+        }
+    }
+
+    float srgbToLinear(float c) {
+        return c <= 0.04045f ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+    }
+
+    float linearToSrgb(float c) {
+        c = std::max(0.0f, c);
+        return c <= 0.0031308f ? c * 12.92f : 1.055f * std::pow(c, 1.0f / 2.4f) - 0.055f;
+    }
+
+    inline vec3f finishTexel(vec3f value, const MipGenerationSettings& settings) {
+        if (settings.renormalize) {
+            float lengthSq = value.lengthSq();
+            return lengthSq > 1e-12f ? value * (1.0f / std::sqrt(lengthSq)) : vec3f(0.0f, 0.0f, 1.0f);
+        }
+        if (settings.gammaCorrect) {
+            return vec3f(linearToSrgb(value.x), linearToSrgb(value.y), linearToSrgb(value.z));
+        }
+        // Sharpening kernels can undershoot
+        return vec3f(std::max(0.0f, value.x), std::max(0.0f, value.y), std::max(0.0f, value.z));
+    }
+
+    // One level down. Each chunk of output rows filters the input rows it needs
+    // horizontally into a small ring (consecutive output rows share input rows),
+    // then blends the ring rows vertically. No full-size temporary is allocated.
+    void downsample(const MipImage& src, MipImage& dst, const MipGenerationSettings& settings, ThreadPool* pool) {
+        dst.width = std::max(1, src.width / 2);
+        dst.height = std::max(1, src.height / 2);
+        dst.pixels.resize(static_cast<size_t>(dst.width) * dst.height);
+        if (settings.filter == MipFilter::Box && !settings.gammaCorrect && src.width == 2 * dst.width && src.height == 2 * dst.height) {
+            forRows(pool, dst.height, [&](int begin, int end) { downsampleBox2x2(src, dst, settings, begin, end); });
+            return;
+        }
+
+        const AxisTaps xTaps = buildAxisTaps(settings.filter, src.width, dst.width);
+        const AxisTaps yTaps = buildAxisTaps(settings.filter, src.height, dst.height);
+        const size_t rowFloats = static_cast<size_t>(dst.width) * 4;
+
+        forRows(pool, dst.height, [&](int begin, int end) {
+            std::vector<float> inputRow(static_cast<size_t>(src.width) * 4);
+            std::vector<float> ring(rowFloats * yTaps.taps);
+            std::vector<int> ringRow(yTaps.taps, -1 - yTaps.taps); // Unwrapped input row held by each slot
+            std::vector<float> sum(rowFloats);
+
+            for (int y = begin; y < end; ++y) {
+                std::fill(sum.begin(), sum.end(), 0.0f);
+                for (int t = 0; t < yTaps.taps; ++t) {
+                    size_t tap = static_cast<size_t>(y) * yTaps.taps + t;
+                    float w = yTaps.weight[tap];
+                    if (w == 0.0f) continue;
+
+                    int k = yTaps.first[y] + t;
+                    int slot = ((k % yTaps.taps) + yTaps.taps) % yTaps.taps;
+                    float* filtered = &ring[slot * rowFloats];
+                    if (ringRow[slot] != k) {
+                        int row = yTaps.index[tap];
+                        const vec3f* in = &src.pixels[static_cast<size_t>(row) * src.width];
+                        if (settings.gammaCorrect || row == src.height - 1) {
+                            // Widen to 4 floats per texel (and linearize)
+                            for (int x = 0; x < src.width; ++x) {
+                                float* texel = &inputRow[static_cast<size_t>(x) * 4];
+                                texel[0] = settings.gammaCorrect ? srgbToLinear(in[x].x) : in[x].x;
+                                texel[1] = settings.gammaCorrect ? srgbToLinear(in[x].y) : in[x].y;
+                                texel[2] = settings.gammaCorrect ? srgbToLinear(in[x].z) : in[x].z;
+                                texel[3] = 0.0f;
+                            }
+                            for (int x = 0; x < dst.width; ++x) {
+                                size_t xTap = static_cast<size_t>(x) * xTaps.taps;
+                                filterTexel<4>(inputRow.data(), &xTaps.index[xTap], &xTaps.weight[xTap], xTaps.taps, filtered + static_cast<size_t>(x) * 4);
+                            }
+                        } else {
+                            const float* rowFloats3 = &in[0].x; // vec3f is three packed floats
+                            for (int x = 0; x < dst.width; ++x) {
+                                size_t xTap = static_cast<size_t>(x) * xTaps.taps;
+                                filterTexel<3>(rowFloats3, &xTaps.index[xTap], &xTaps.weight[xTap], xTaps.taps, filtered + static_cast<size_t>(x) * 4);
+                            }
+                        }
+                        ringRow[slot] = k;
+                    }
+                    maddRow(sum.data(), filtered, w, rowFloats);
+                }
+
+                vec3f* out = &dst.pixels[static_cast<size_t>(y) * dst.width];
+                for (int x = 0; x < dst.width; ++x) {
+                    const float* texel = &sum[static_cast<size_t>(x) * 4];
+                    out[x] = finishTexel(vec3f(texel[0], texel[1], texel[2]), settings);
+                }
+            }
+        });
+    }
+
+} // end anonymous namespace
+
+void generateMipChain(std::vector<MipImage>& chain, const MipGenerationSettings& settings, ThreadPool* pool) {
+    if (chain.empty() || chain[0].width <= 0 || chain[0].height <= 0) return;
+    chain.resize(1);
+    while (chain.back().width > 1 || chain.back().height > 1) {
+        MipImage next;
+        downsample(chain.back(), next, settings, pool);
+        chain.push_back(std::move(next));
+    }
+}
@@ -0,0 +1,61 @@
+// src/core/texture/packed_texture.cpp
+#include "core/texture/packed_texture.h"
+
+namespace { // Anonymous namespace for internal linkage helper functions
+
+    // Finest source level that is not larger than the target level
+    const Texture::MipLevel& matchingLevel(const Texture& source, int width, int height) {
+        for (size_t i = 0; i < source.getNumLevels(); ++i) {
+            const Texture::MipLevel& level = source.getLevel(i);
+            if (level.width <= width && level.height <= height) return level;
+        }
+        return source.getLevel(source.getNumLevels() - 1);
+    }
+
+} // end anonymous namespace
+
+std::shared_ptr<PackedTexture> PackedTexture::create(const Texture* const channels[MaxChannels], TexelLayout layout) {
+    // The largest source defines the packed mip chain
+    const Texture* reference = nullptr;
+    uint32_t channelMask = 0;
+    for (int c = 0; c < MaxChannels; ++c) {
+        const Texture* source = channels[c];
+        if (!source || source->empty()) continue;
+        channelMask |= 1u << c;
+        if (!reference || source->getWidth() * source->getHeight() > reference->getWidth() * reference->getHeight()) {
+            reference = source;
+        }
+    }
+    if (!reference) return nullptr;
+
+    TexelFormat format = channelMask >= 4u ? TexelFormat::RGBA8 : (channelMask >= 2u ? TexelFormat::RG8Unorm : TexelFormat::R8);
+    std::shared_ptr<PackedTexture> texture(new PackedTexture());
+    texture->channelMask = channelMask;
+    texture->options.usage = TextureUsage::Scalar;
+    texture->options.layout = layout;
+    texture->mipLevels.resize(reference->getNumLevels());
+
+    std::vector<vec3f> pixels;
+    for (size_t i = 0; i < reference->getNumLevels(); ++i) {
+        int width = reference->getLevel(i).width;
+        int height = reference->getLevel(i).height;
+        pixels.assign(static_cast<size_t>(width) * height, vec3f(0.0f, 0.0f, 0.0f));
+
+        for (int c = 0; c < MaxChannels; ++c) {
+            const Texture* source = channels[c];
+            if (!source || source->empty()) continue;
+            const MipLevel& level = matchingLevel(*source, width, height);
+            bool sameSize = level.width == width && level.height == height;
+            for (int y = 0; y < height; ++y) {
+                for (int x = 0; x < width; ++x) {
+                    float value = sameSize ? level.fetch(x, y).x
+                                           : sampleBilinear(level, (x + 0.5f) / width, (y + 0.5f) / height).x;
+                    vec3f& pixel = pixels[static_cast<size_t>(y) * width + x];
+                    (c == 0 ? pixel.x : (c == 1 ? pixel.y : pixel.z)) = value;
+                }
+            }
+        }
+        encodeLevel(pixels, width, height, format, texture->mipLevels[i], layout);
+    }
+    return texture;
+}
@@ -0,0 +1,10 @@
+// src/core/texture/solid_texture.cpp
+#include "core/texture/solid_texture.h"
+
+std::shared_ptr<SolidTexture> SolidTexture::create(const vec3f& value, TextureUsage usage) {
+    std::shared_ptr<SolidTexture> texture(new SolidTexture());
+    texture->options.usage = usage;
+    texture->mipLevels.resize(1);
+    encodeLevel(std::vector<vec3f>(1, value), 1, 1, defaultFormatForUsage(usage), texture->mipLevels[0]);
+    return texture;
+}
@@ -1,41 +1,390 @@
 // core/texture/texture.cpp
 #include "core/texture/texture.h"
+#include "core/texture/block_compression.h"
+#include <atomic>
+
+namespace { // Anonymous namespace for internal linkage helper functions
+
+    using BilinearTaps = Texture::TexelFootprint;
+
+    inline bool isPowerOfTwo(int n) { return n > 0 && (n & (n - 1)) == 0; }
+
+    // log2 from the exponent bits plus a quadratic fit of the mantissa (max error ~0.005);
+    // plenty for picking a mip level. x must be positive and normal.
+    inline float fastLog2(float x) {
+        uint32_t bits;
+        std::memcpy(&bits, &x, sizeof(bits));
+        float exponent = static_cast<float>(static_cast<int32_t>(bits >> 23) - 127);
+        bits = (bits & 0x007FFFFFu) | 0x3F800000u; // Mantissa as a float in [1, 2)
+        float m;
+        std::memcpy(&m, &bits, sizeof(m));
+        return exponent + (-0.34484843f * m + 2.02466578f) * m - 1.67487759f;
+    }
+
+#ifndef NaiveMethod
+    // floor() for SSE2 (no roundps): truncate, then step down where truncation rounded up
+    inline __m128 floor4(__m128 x) {
+        __m128 t = _mm_cvtepi32_ps(_mm_cvttps_epi32(x));
+        return _mm_sub_ps(t, _mm_and_ps(_mm_cmpgt_ps(t, x), _mm_set1_ps(1.0f)));
+    }
+#endif
+
+    // tx, ty: texel-space positions, texel centers at integers. Power-of-two levels
+    // wrap with a mask and accept any coordinate; other levels expect tx in [-1, width).
+    // x and y share one register
+    template <bool PowerOfTwo>
+    inline BilinearTaps computeTaps(const Texture::MipLevel& level, float tx, float ty) {
+        BilinearTaps taps;
+#ifdef NaiveMethod
+        float fx = std::floor(tx), fy = std::floor(ty);
+        int x0 = static_cast<int>(fx), y0 = static_cast<int>(fy);
+        taps.u_frac = tx - fx;
+        taps.v_frac = ty - fy;
+#else
+        __m128 t = _mm_set_ps(0.0f, 0.0f, ty, tx);
+        __m128 f = floor4(t);
+        __m128 frac = _mm_sub_ps(t, f);
+        __m128i i = _mm_cvttps_epi32(f);
+        int x0 = _mm_cvtsi128_si32(i);
+        int y0 = _mm_cvtsi128_si32(_mm_shuffle_epi32(i, _MM_SHUFFLE(1, 1, 1, 1)));
+        taps.u_frac = _mm_cvtss_f32(frac);
+        taps.v_frac = _mm_cvtss_f32(_mm_shuffle_ps(frac, frac, _MM_SHUFFLE(1, 1, 1, 1)));
+#endif
+        if constexpr (PowerOfTwo) {
+            taps.x0 = x0 & (level.width - 1);
+            taps.y0 = y0 & (level.height - 1);
+            taps.x1 = (x0 + 1) & (level.width - 1);
+            taps.y1 = (y0 + 1) & (level.height - 1);
+        } else {
+            taps.x0 = x0 < 0 ? x0 + level.width : x0;
+            taps.y0 = y0 < 0 ? y0 + level.height : y0;
+            taps.x1 = taps.x0 + 1 == level.width ? 0 : taps.x0 + 1;
+            taps.y1 = taps.y0 + 1 == level.height ? 0 : taps.y0 + 1;
+        }
+        return taps;
+    }
+
+    // --- Per-thread cache of decoded BC blocks ---
+    // Direct mapped; the slot comes from the low 3 bits of the block coordinates,
+    // so the (up to) four blocks under a bilinear footprint never evict each other.
+    struct DecodedBlock {
+        uint32_t levelId;    // MipLevel::blockCacheId, 0 = empty slot
+        uint32_t blockIndex;
+        unsigned char texels[16][4];
+    };
+
+    constexpr int BlockCacheSlots = 64;
+    thread_local DecodedBlock blockCache[BlockCacheSlots]; // Zero-initialized, 4.5 KB per thread
+
+    std::atomic<uint32_t> nextBlockCacheId{1};
+
+    inline const unsigned char* compressedTexel(const Texture::MipLevel& level, int x, int y) {
+        int bx = x >> 2, by = y >> 2;
+        uint32_t blockIndex = static_cast<uint32_t>(by * ((level.width + 3) >> 2) + bx);
+        uint32_t slot = (static_cast<uint32_t>((bx & 7) | ((by & 7) << 3)) ^ (level.blockCacheId * 13u)) & (BlockCacheSlots - 1);
+        DecodedBlock& entry = blockCache[slot];
+        if (entry.levelId != level.blockCacheId || entry.blockIndex != blockIndex) {
+            decodeBlockRGBA8(level.format, level.data.data() + blockIndex * bytesPerBlock(level.format), entry.texels);
+            entry.levelId = level.blockCacheId;
+            entry.blockIndex = blockIndex;
+        }
+        return entry.texels[((y & 3) << 2) | (x & 3)];
+    }
+
+#ifdef NaiveMethod
+    // Reference path: decode each texel, blend in scalar
+    vec3f blendScalar(const Texture::MipLevel& level, const BilinearTaps& t) {
+        vec3f c00 = level.fetch(t.x0, t.y0);
+        vec3f c10 = level.fetch(t.x1, t.y0);
+        vec3f c01 = level.fetch(t.x0, t.y1);
+        vec3f c11 = level.fetch(t.x1, t.y1);
+
+        vec3f top = c00 * (1.0f - t.u_frac) + c10 * t.u_frac;
+        vec3f bottom = c01 * (1.0f - t.u_frac) + c11 * t.u_frac;
+        return top * (1.0f - t.v_frac) + bottom * t.v_frac;
+    }
+#endif
+
+#ifndef NaiveMethod
+    // Widen up to 4 unorm8 channels into a float vector (SSE2 only)
+    inline __m128 unpackUnorm8(int32_t bits) {
+        const __m128i zero = _mm_setzero_si128();
+        __m128i v = _mm_cvtsi32_si128(bits);
+        v = _mm_unpacklo_epi8(v, zero);
+        v = _mm_unpacklo_epi16(v, zero);
+        return _mm_cvtepi32_ps(v);
+    }
+
+    inline __m128 loadRGBA8(const unsigned char* p) {
+        int32_t bits;
+        std::memcpy(&bits, p, 4);
+        return unpackUnorm8(bits);
+    }
+
+    inline __m128 loadRG8(const unsigned char* p) {
+        uint16_t bits;
+        std::memcpy(&bits, p, 2);
+        return unpackUnorm8(bits);
+    }
+
+    inline __m128 loadRGBA16F(const unsigned char* p) {
+#if defined(__F16C__) || defined(__AVX2__)
+        return _mm_cvtph_ps(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(p)));
+#else
+        uint16_t h[4];
+        std::memcpy(h, p, sizeof(h));
+        return _mm_set_ps(halfToFloat(h[3]), halfToFloat(h[2]), halfToFloat(h[1]), halfToFloat(h[0]));
+#endif
+    }
+
+    inline __m128 lerp4(__m128 a, __m128 b, __m128 t) {
+        return _mm_add_ps(a, _mm_mul_ps(_mm_sub_ps(b, a), t));
+    }
+
+    // Pointers to the four texels of a footprint, using the separable layout addressing
+    struct QuadTexels {
+        const unsigned char *p00, *p10, *p01, *p11;
+    };
+
+    inline QuadTexels quadTexels(const Texture::MipLevel& level, const BilinearTaps& t) {
+        const int stride = bytesPerTexel(level.format);
+        const unsigned char* row0 = level.data.data() + level.rowOffset(t.y0) * stride;
+        const unsigned char* row1 = level.data.data() + level.rowOffset(t.y1) * stride;
+        size_t col0 = level.columnOffset(t.x0) * stride;
+        size_t col1 = level.columnOffset(t.x1) * stride;
+        return { row0 + col0, row0 + col1, row1 + col0, row1 + col1 };
+    }
+
+    template <__m128 (*Load)(const unsigned char*)>
+    inline __m128 blendQuad(const Texture::MipLevel& level, const BilinearTaps& t) {
+        __m128 fu = _mm_set1_ps(t.u_frac);
+        __m128 fv = _mm_set1_ps(t.v_frac);
+        QuadTexels q = quadTexels(level, t);
+        __m128 top = lerp4(Load(q.p00), Load(q.p10), fu);
+        __m128 bottom = lerp4(Load(q.p01), Load(q.p11), fu);
+        return lerp4(top, bottom, fv);
+    }
+
+    inline vec3f toVec3(__m128 v) {
+        alignas(16) float out[4];
+        _mm_store_ps(out, v);
+        return vec3f(out[0], out[1], out[2]);
+    }
+#endif
+
+    // Format-specialized bilinear blend
+    template <TexelFormat Format>
+    vec3f blend(const Texture::MipLevel& level, const BilinearTaps& t);
+
+    template <>
+    vec3f blend<TexelFormat::RGBA8>(const Texture::MipLevel& level, const BilinearTaps& t) {
+#ifdef NaiveMethod
+        return blendScalar(level, t);
+#else
+        return toVec3(_mm_mul_ps(blendQuad<loadRGBA8>(level, t), _mm_set1_ps(1.0f / 255.0f)));
+#endif
+    }
+
+    template <>
+    vec3f blend<TexelFormat::RG8>(const Texture::MipLevel& level, const BilinearTaps& t) {
+#ifdef NaiveMethod
+        return blendScalar(level, t);
+#else
+        // Filter the biased x/y, then unbias and rebuild z: the result is unit length
+        __m128 xy = _mm_sub_ps(_mm_mul_ps(blendQuad<loadRG8>(level, t), _mm_set1_ps(2.0f / 255.0f)), _mm_set1_ps(1.0f));
+        vec3f n = toVec3(xy);
+        n.z = reconstructZ(n.x, n.y);
+        return n;
+#endif
+    }
+
+    template <>
+    vec3f blend<TexelFormat::RG8Unorm>(const Texture::MipLevel& level, const BilinearTaps& t) {
+#ifdef NaiveMethod
+        return blendScalar(level, t);
+#else
+        return toVec3(_mm_mul_ps(blendQuad<loadRG8>(level, t), _mm_set1_ps(1.0f / 255.0f)));
+#endif
+    }
+
+    template <>
+    vec3f blend<TexelFormat::R8>(const Texture::MipLevel& level, const BilinearTaps& t) {
+#ifdef NaiveMethod
+        return blendScalar(level, t);
+#else
+        // All four taps in one register, dotted with the four bilinear weights
+        QuadTexels q = quadTexels(level, t);
+        int32_t bits = q.p00[0] | (q.p10[0] << 8) | (q.p01[0] << 16) | (q.p11[0] << 24);
+        __m128 taps = unpackUnorm8(bits);
+        float iu = 1.0f - t.u_frac, iv = 1.0f - t.v_frac;
+        __m128 weights = _mm_set_ps(t.u_frac * t.v_frac, iu * t.v_frac, t.u_frac * iv, iu * iv);
+        __m128 prod = _mm_mul_ps(taps, weights);
+        prod = _mm_add_ps(prod, _mm_movehl_ps(prod, prod));
+        prod = _mm_add_ss(prod, _mm_shuffle_ps(prod, prod, _MM_SHUFFLE(1, 1, 1, 1)));
+        float r = _mm_cvtss_f32(prod) * (1.0f / 255.0f);
+        return vec3f(r, r, r);
+#endif
+    }
+
+    template <>
+    vec3f blend<TexelFormat::RGBA16F>(const Texture::MipLevel& level, const BilinearTaps& t) {
+#ifdef NaiveMethod
+        return blendScalar(level, t);
+#else
+        return toVec3(blendQuad<loadRGBA16F>(level, t));
+#endif
+    }
+
+    // Block compressed: fetch decoded RGBA8 texels from the block cache.
+    // Each tap is copied out before the next lookup, which may reuse the slot.
+    vec3f blendCompressed(const Texture::MipLevel& level, const BilinearTaps& t) {
+#ifdef NaiveMethod
+        return blendScalar(level, t);
+#else
+        __m128 fu = _mm_set1_ps(t.u_frac);
+        __m128 fv = _mm_set1_ps(t.v_frac);
+        __m128 c00 = loadRGBA8(compressedTexel(level, t.x0, t.y0));
+        __m128 c10 = loadRGBA8(compressedTexel(level, t.x1, t.y0));
+        __m128 c01 = loadRGBA8(compressedTexel(level, t.x0, t.y1));
+        __m128 c11 = loadRGBA8(compressedTexel(level, t.x1, t.y1));
+        __m128 color = lerp4(lerp4(c00, c10, fu), lerp4(c01, c11, fu), fv);
+        vec3f result = toVec3(_mm_mul_ps(color, _mm_set1_ps(1.0f / 255.0f)));
+        if (level.format == TexelFormat::BC5) return decodeNormalXY(result.x, result.y);
+        return result;
+#endif
+    }
+
+    inline vec3f blendTaps(const Texture::MipLevel& level, const BilinearTaps& taps) {
+        switch (level.format) {
+            case TexelFormat::RGBA8:   return blend<TexelFormat::RGBA8>(level, taps);
+            case TexelFormat::RG8:     return blend<TexelFormat::RG8>(level, taps);
+            case TexelFormat::RG8Unorm: return blend<TexelFormat::RG8Unorm>(level, taps);
+            case TexelFormat::R8:      return blend<TexelFormat::R8>(level, taps);
+            case TexelFormat::RGBA16F: return blend<TexelFormat::RGBA16F>(level, taps);
+            case TexelFormat::BC1:
+            case TexelFormat::BC3:
+            case TexelFormat::BC5:
+            case TexelFormat::BC4:
+            case TexelFormat::BC7:     return blendCompressed(level, taps);
+        }
+        return vec3f(1.0f, 0.0f, 1.0f);
+    }
+
+} // end anonymous namespace
 
 vec3f Texture::sampleBilinear(const MipLevel& level, float u, float v)  {
-    if (level.pixels.empty() || level.width <= 0 || level.height <= 0) {
+    if (level.data.empty() || level.width <= 0 || level.height <= 0) {
         return vec3f(1.0f, 0.0f, 1.0f); // Error color
     }
+    return blendTaps(level, computeFootprint(level, u, v));
+}
+
+Texture::TexelFootprint Texture::computeFootprint(const MipLevel& level, float u, float v) {
+    if (isPowerOfTwo(level.width) && isPowerOfTwo(level.height)) {
+        // Mask-based wrap, no need to wrap u and v first
+        return computeTaps<true>(level, u * level.width - 0.5f, v * level.height - 0.5f);
+    }
 
     // Wrap coordinates
     u = u - std::floor(u);
     v = v - std::floor(v);
 
     // Calculate exact texture coordinates (center of pixel is at .5)
-    float tx = u * level.width - 0.5f;
-    float ty = v * level.height - 0.5f;
-
-    // Integer pixel coordinates
-    int x0 = static_cast<int>(std::floor(tx));
-    int y0 = static_cast<int>(std::floor(ty));
-
-    // Interpolation weights
-    float u_frac = tx - x0;
-    float v_frac = ty - y0;
-
-    // Sample 4 neighbors (with clamping)
-    auto getPixelClamped = [&](int x, int y) -> const vec3f& {
-        x = std::max(0, std::min(level.width - 1, x));
-        y = std::max(0, std::min(level.height - 1, y));
-        return level.pixels[y * level.width + x];
-    };
+    return computeTaps<false>(level, u * level.width - 0.5f, v * level.height - 0.5f);
+}
+
+vec3f Texture::blendFootprint(const MipLevel& level, const TexelFootprint& footprint) {
+    return blendTaps(level, footprint);
+}
+
+vec3f Texture::sampleBilinearTexel(const MipLevel& level, float tx, float ty) {
+    return blendTaps(level, computeTaps<false>(level, tx, ty));
+}
+
+float Texture::computeLod(const vec2f& ddx, const vec2f& ddy) const {
+    return lodForSize(ddx, ddy, mipLevels[0].width, mipLevels[0].height);
+}
+
+float Texture::lodForSize(const vec2f& ddx, const vec2f& ddy, int width, int height) {
+    float baseWidth = static_cast<float>(width);
+    float baseHeight = static_cast<float>(height);
+
+    // Calculate rho squared
+    float rho_sq = std::max(ddx.lengthSq() * baseWidth * baseWidth,
+                            ddy.lengthSq() * baseHeight * baseHeight);
+
+    // LOD = log2(rho) clamped to >= 0, i.e. 0 for rho <= 1
+    if (!(rho_sq > 1.0f)) return 0.0f;
+    return 0.5f * fastLog2(rho_sq);
+}
+
+// Trilinear sampling using derivatives, shared by all texture types
+vec3f Texture::sample(float u, float v, const vec2f& ddx, const vec2f& ddy) const {
+    if (mipLevels.empty() || mipLevels[0].data.empty()) {
+        return vec3f(1.0f, 0.0f, 1.0f); // Magenta error color
+    }
+
+    float lod = computeLod(ddx, ddy);
+
+    // Determine levels and interpolation factor (lod >= 0, so truncation is floor)
+    int maxLevel = static_cast<int>(mipLevels.size()) - 1;
+    int level0_idx = std::min(static_cast<int>(lod), maxLevel);
+
+    vec3f color0 = sampleBilinear(mipLevels[level0_idx], u, v);
+
+    float level_t = lod - static_cast<float>(level0_idx);
+    if (level0_idx == maxLevel || level_t <= 0.0f) {
+        return color0; // Only one level needed
+    }
+
+    vec3f color1 = sampleBilinear(mipLevels[level0_idx + 1], u, v);
+
+    // Trilinear interpolation
+    return color0 * (1.0f - level_t) + color1 * level_t;
+}
+
+vec3f Texture::MipLevel::fetch(int x, int y) const {
+    if (isBlockCompressed(format)) {
+        // BC5 decodes to red/green like RG8, the others to RGBA8 (BC4 replicates red into RGB)
+        return decodeTexel(format == TexelFormat::BC5 ? TexelFormat::RG8 : TexelFormat::RGBA8, compressedTexel(*this, x, y));
+    }
+    return decodeTexel(format, texel(x, y));
+}
+
+void Texture::encodeLevel(const std::vector<vec3f>& pixels, int width, int height, TexelFormat format, MipLevel& outLevel,
+                          TexelLayout layout) {
+    outLevel.width = width;
+    outLevel.height = height;
+    outLevel.format = format;
+    outLevel.layout = layout;
+    size_t count = static_cast<size_t>(width) * height;
+    if (layout == TexelLayout::Tiled4x4) {
+        count = static_cast<size_t>((width + 3) / 4) * ((height + 3) / 4) * 16;
+    }
+    int stride = bytesPerTexel(format);
+    outLevel.data.assign(count * stride, 0); // Tile padding stays zero, it is never sampled
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            encodeTexel(format, pixels[static_cast<size_t>(y) * width + x], outLevel.data.data() + outLevel.texelIndex(x, y) * stride);
+        }
+    }
+}
+
+void Texture::storeBlockLevel(std::vector<unsigned char>&& blocks, int width, int height, TexelFormat format, MipLevel& outLevel) {
+    outLevel.width = width;
+    outLevel.height = height;
+    outLevel.format = format;
+    outLevel.data = std::move(blocks);
+    // Fresh id per level so stale cache entries of a freed level can never match
+    outLevel.blockCacheId = newBlockCacheId();
+}
 
-    const vec3f& c00 = getPixelClamped(x0, y0);
-    const vec3f& c10 = getPixelClamped(x0 + 1, y0);
-    const vec3f& c01 = getPixelClamped(x0, y0 + 1);
-    const vec3f& c11 = getPixelClamped(x0 + 1, y0 + 1);
+uint32_t Texture::newBlockCacheId() {
+    return nextBlockCacheId.fetch_add(1, std::memory_order_relaxed);
+}
 
-    // Bilinear interpolation
-    vec3f top = c00 * (1.0f - u_frac) + c10 * u_frac;
-    vec3f bottom = c01 * (1.0f - u_frac) + c11 * u_frac;
-    return top * (1.0f - v_frac) + bottom * v_frac;
-}
\ No newline at end of file
+size_t Texture::getMemoryUsage() const {
+    size_t bytes = 0;
+    for (const auto& level : mipLevels) bytes += level.data.size();
+    return bytes;
+}
@@ -0,0 +1,149 @@
+// src/core/texture/texture_cache_file.cpp
+#include "core/texture/texture_cache_file.h"
+#include "core/texture/block_compression.h"
+#include "io/cache_file.h"
+#include "io/mapped_file.h"
+#include <cstring>
+
+namespace { // Anonymous namespace for internal linkage helper functions
+
+    constexpr uint32_t CacheMagic = 0x43545253u; // "SRTC"
+    constexpr uint32_t CacheVersion = 2;          // 2: TGA origin flips fixed in the streaming reader
+    constexpr size_t DataAlignment = 64;         // Level data offsets, keeps texel rows cache line aligned
+
+    struct FileHeader {
+        uint32_t magic;
+        uint32_t version;
+        uint64_t sourceSize;
+        int64_t sourceTime;  // Source last write time, in file clock ticks
+        uint32_t keyLength;  // Followed by the key (absolute source path + load options)
+        uint32_t numLevels;  // Then numLevels FileLevel entries, then the aligned level data
+    };
+
+    struct FileLevel {
+        int32_t width;
+        int32_t height;
+        uint8_t format;
+        uint8_t layout;
+        uint8_t reserved[6];
+        uint64_t offset;
+        uint64_t size;
+    };
+
+    static_assert(sizeof(FileHeader) == 32 && sizeof(FileLevel) == 32, "Cache file structs must not be padded");
+
+    // Texture that only exists as a view of a cache file
+    class CachedTexture : public Texture {
+        bool load(const std::string&) override { return false; }
+    };
+
+    std::string cacheKeyFor(const std::string& filename, const TextureLoadOptions& options) {
+        return options.cacheKey(CacheFile::sourceKey(filename));
+    }
+
+    // Bytes a level of these dimensions occupies (tiled levels are padded to whole tiles)
+    size_t expectedLevelSize(int width, int height, TexelFormat format, TexelLayout layout) {
+        if (isBlockCompressed(format)) return blockLevelSize(format, width, height);
+        size_t count = static_cast<size_t>(width) * height;
+        if (layout == TexelLayout::Tiled4x4) count = static_cast<size_t>((width + 3) / 4) * ((height + 3) / 4) * 16;
+        return count * bytesPerTexel(format);
+    }
+
+    bool validLevel(const FileLevel& level) {
+        if (level.width <= 0 || level.height <= 0 || level.format > static_cast<uint8_t>(TexelFormat::RG8Unorm) ||
+            level.layout > static_cast<uint8_t>(TexelLayout::Tiled4x4)) {
+            return false;
+        }
+        return level.size == expectedLevelSize(level.width, level.height, static_cast<TexelFormat>(level.format),
+                                                static_cast<TexelLayout>(level.layout));
+    }
+
+} // end anonymous namespace
+
+std::string TextureCacheFile::cachePath(const std::string& cacheDirectory, const std::string& filename, const TextureLoadOptions& options) {
+    return CacheFile::path(cacheDirectory, cacheKeyFor(filename, options), ".texcache");
+}
+
+std::shared_ptr<Texture> TextureCacheFile::load(const std::string& cacheDirectory, const std::string& filename, const TextureLoadOptions& options) {
+    uint64_t sourceSize;
+    int64_t sourceTime;
+    if (!CacheFile::sourceStamp(filename, sourceSize, sourceTime)) return nullptr;
+
+    std::shared_ptr<const MappedFile> file = MappedFile::open(cachePath(cacheDirectory, filename, options));
+    if (!file || file->size() < sizeof(FileHeader)) return nullptr;
+
+    FileHeader header;
+    std::memcpy(&header, file->data(), sizeof(header));
+    std::string key = cacheKeyFor(filename, options);
+    if (header.magic != CacheMagic || header.version != CacheVersion) return nullptr;
+    if (header.sourceSize != sourceSize || header.sourceTime != sourceTime) return nullptr; // Source changed: stale
+    size_t tableOffset = sizeof(FileHeader) + header.keyLength;
+    if (header.keyLength != key.size() || header.numLevels == 0 ||
+        tableOffset + static_cast<size_t>(header.numLevels) * sizeof(FileLevel) > file->size() ||
+        std::memcmp(file->data() + sizeof(FileHeader), key.data(), key.size()) != 0) {
+        return nullptr; // Hash collision or truncated file
+    }
+
+    std::shared_ptr<Texture> texture = std::make_shared<CachedTexture>();
+    texture->options = options;
+    texture->mipLevels.resize(header.numLevels);
+    for (uint32_t i = 0; i < header.numLevels; ++i) {
+        FileLevel entry;
+        std::memcpy(&entry, file->data() + tableOffset + i * sizeof(FileLevel), sizeof(entry));
+        if (!validLevel(entry) || entry.offset > file->size() || entry.size > file->size() - entry.offset) return nullptr;
+
+        Texture::MipLevel& level = texture->mipLevels[i];
+        level.width = entry.width;
+        level.height = entry.height;
+        level.format = static_cast<TexelFormat>(entry.format);
+        level.layout = static_cast<TexelLayout>(entry.layout);
+        level.data = TexelStorage::mapped(file, file->data() + entry.offset, entry.size);
+        if (isBlockCompressed(level.format)) level.blockCacheId = Texture::newBlockCacheId();
+    }
+    return texture;
+}
+
+bool TextureCacheFile::store(const std::string& cacheDirectory, const std::string& filename, const TextureLoadOptions& options, const Texture& texture) {
+    uint64_t sourceSize;
+    int64_t sourceTime;
+    if (texture.mipLevels.empty() || !CacheFile::sourceStamp(filename, sourceSize, sourceTime)) return false;
+
+    std::string key = cacheKeyFor(filename, options);
+    FileHeader header = {};
+    header.magic = CacheMagic;
+    header.version = CacheVersion;
+    header.sourceSize = sourceSize;
+    header.sourceTime = sourceTime;
+    header.keyLength = static_cast<uint32_t>(key.size());
+    header.numLevels = static_cast<uint32_t>(texture.mipLevels.size());
+
+    std::vector<FileLevel> table(texture.mipLevels.size());
+    uint64_t offset = sizeof(FileHeader) + key.size() + table.size() * sizeof(FileLevel);
+    for (size_t i = 0; i < table.size(); ++i) {
+        const Texture::MipLevel& level = texture.mipLevels[i];
+        if (level.data.empty()) return false; // Nothing to cache for paged levels
+        offset = (offset + DataAlignment - 1) & ~static_cast<uint64_t>(DataAlignment - 1);
+        table[i] = {};
+        table[i].width = level.width;
+        table[i].height = level.height;
+        table[i].format = static_cast<uint8_t>(level.format);
+        table[i].layout = static_cast<uint8_t>(level.layout);
+        table[i].offset = offset;
+        table[i].size = level.data.size();
+        offset += level.data.size();
+    }
+
+    return CacheFile::writeAtomically(cachePath(cacheDirectory, filename, options), [&](std::ofstream& out) {
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(key.data(), static_cast<std::streamsize>(key.size()));
+        out.write(reinterpret_cast<const char*>(table.data()), static_cast<std::streamsize>(table.size() * sizeof(FileLevel)));
+        const char padding[DataAlignment] = {};
+        uint64_t written = sizeof(FileHeader) + key.size() + table.size() * sizeof(FileLevel);
+        for (size_t i = 0; i < table.size(); ++i) {
+            out.write(padding, static_cast<std::streamsize>(table[i].offset - written));
+            out.write(reinterpret_cast<const char*>(texture.mipLevels[i].data.data()), static_cast<std::streamsize>(table[i].size));
+            written = table[i].offset + table[i].size;
+        }
+        return true;
+    });
+}
@@ -0,0 +1,328 @@
+// src/core/texture/virtual_texture.cpp
+#include "core/texture/virtual_texture.h"
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+// --- VirtualTexture ---
+
+VirtualTexture::~VirtualTexture() {
+    cache.forget(*this);
+    std::error_code ec;
+    std::filesystem::remove(pageFile, ec);
+}
+
+std::shared_ptr<VirtualTexture> VirtualTexture::create(const Texture& source, const std::string& pageFile, VirtualTextureCache& cache) {
+    if (source.empty()) return nullptr;
+    TexelFormat format = source.getFormat();
+    if (isBlockCompressed(format)) {
+        std::cerr << "Error: Virtual textures need uncompressed levels, got " << texelFormatName(format) << std::endl;
+        return nullptr;
+    }
+
+    std::shared_ptr<VirtualTexture> texture(new VirtualTexture(cache));
+    texture->options = source.getOptions();
+    texture->pageFile = pageFile;
+    const int stride = bytesPerTexel(format);
+    texture->pageBytes = static_cast<size_t>(PageStride) * PageStride * stride;
+
+    // Every level larger than one page is paged, the rest is the resident tail
+    size_t numLevels = source.getNumLevels();
+    texture->mipLevels.resize(numLevels);
+    size_t totalPages = 0;
+    for (size_t i = 0; i < numLevels; ++i) {
+        const MipLevel& level = source.getLevel(i);
+        if (level.width <= PageSize && level.height <= PageSize) break;
+        PagedLevel paged;
+        paged.pagesWide = (level.width + PageSize - 1) / PageSize;
+        paged.pagesHigh = (level.height + PageSize - 1) / PageSize;
+        paged.firstPage = totalPages;
+        totalPages += static_cast<size_t>(paged.pagesWide) * paged.pagesHigh;
+        texture->pagedLevels.push_back(paged);
+    }
+    texture->pages = std::make_unique<Page[]>(totalPages);
+    texture->pageCount = totalPages;
+
+    std::ofstream file(pageFile, std::ios::binary | std::ios::trunc);
+    if (!file) {
+        std::cerr << "Error: Failed to create virtual texture page file: " << pageFile << std::endl;
+        return nullptr;
+    }
+
+    // Pages in order, each with a border that wraps around like the sampler does
+    std::vector<unsigned char> pageData(texture->pageBytes);
+    for (size_t i = 0; i < texture->pagedLevels.size(); ++i) {
+        const MipLevel& level = source.getLevel(i);
+        const PagedLevel& paged = texture->pagedLevels[i];
+        for (int py = 0; py < paged.pagesHigh; ++py) {
+            for (int px = 0; px < paged.pagesWide; ++px) {
+                for (int y = 0; y < PageStride; ++y) {
+                    int sy = (py * PageSize + y - 1 + level.height) % level.height;
+                    for (int x = 0; x < PageStride; ++x) {
+                        int sx = (px * PageSize + x - 1 + level.width) % level.width;
+                        std::memcpy(pageData.data() + (static_cast<size_t>(y) * PageStride + x) * stride, level.texel(sx, sy), stride);
+                    }
+                }
+                file.write(reinterpret_cast<const char*>(pageData.data()), pageData.size());
+            }
+        }
+
+        MipLevel& dims = texture->mipLevels[i]; // Dimensions only, the texels live in pages
+        dims.width = level.width;
+        dims.height = level.height;
+        dims.format = format;
+    }
+
+    if (!file) {
+        std::cerr << "Error: Failed to write virtual texture page file: " << pageFile << std::endl;
+        return nullptr; // Destructor removes the partial file
+    }
+
+    for (size_t i = texture->pagedLevels.size(); i < numLevels; ++i) {
+        texture->mipLevels[i] = source.getLevel(i);
+    }
+
+    cache.registerTexture(texture);
+    return texture;
+}
+
+vec3f VirtualTexture::sampleLevel(int level, float u, float v) const {
+    uint32_t currentFrame = cache.getFrame();
+
+    // Wrap coordinates
+    u = u - std::floor(u);
+    v = v - std::floor(v);
+
+    for (; level < static_cast<int>(pagedLevels.size()); ++level) {
+        const MipLevel& dims = mipLevels[level];
+        float tx = u * dims.width - 0.5f;
+        float ty = v * dims.height - 0.5f;
+        int px = std::clamp(static_cast<int>(std::floor(tx)), 0, dims.width - 1) / PageSize;
+        int py = std::clamp(static_cast<int>(std::floor(ty)), 0, dims.height - 1) / PageSize;
+
+        const PagedLevel& paged = pagedLevels[level];
+        Page& page = pages[paged.firstPage + static_cast<size_t>(py) * paged.pagesWide + px];
+        if (!page.texels.data.empty()) {
+            // Check before storing so resident pages do not bounce cache lines between workers
+            if (page.lastUsedFrame.load(std::memory_order_relaxed) != currentFrame) {
+                page.lastUsedFrame.store(currentFrame, std::memory_order_relaxed);
+            }
+            return sampleBilinearTexel(page.texels, tx - px * PageSize + 1.0f, ty - py * PageSize + 1.0f);
+        }
+
+        // Missing: record feedback and fall back to the next coarser level
+        if (page.requestedFrame.load(std::memory_order_relaxed) != currentFrame) {
+            page.requestedFrame.store(currentFrame, std::memory_order_relaxed);
+        }
+    }
+    return sampleBilinear(mipLevels[level], u, v); // Resident tail
+}
+
+vec3f VirtualTexture::sample(float u, float v, const vec2f& ddx, const vec2f& ddy) const {
+    if (empty()) {
+        return vec3f(1.0f, 0.0f, 1.0f); // Magenta error color
+    }
+
+    float lod = computeLod(ddx, ddy);
+
+    int maxLevel = static_cast<int>(mipLevels.size()) - 1;
+    int level0_idx = std::min(static_cast<int>(lod), maxLevel);
+
+    vec3f color0 = sampleLevel(level0_idx, u, v);
+    if (level0_idx == maxLevel) {
+        return color0;
+    }
+
+    vec3f color1 = sampleLevel(level0_idx + 1, u, v);
+    float level_t = lod - static_cast<float>(level0_idx);
+
+    // Trilinear interpolation
+    return color0 * (1.0f - level_t) + color1 * level_t;
+}
+
+
+// --- VirtualTextureCache ---
+
+VirtualTextureCache::VirtualTextureCache(size_t budgetBytes)
+    : budget(budgetBytes) {
+    loader = std::thread(&VirtualTextureCache::loaderThread, this);
+}
+
+VirtualTextureCache::~VirtualTextureCache() {
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        stop = true;
+    }
+    condition.notify_all();
+    if (loader.joinable()) loader.join();
+}
+
+void VirtualTextureCache::registerTexture(const std::shared_ptr<VirtualTexture>& texture) {
+    std::unique_lock<std::mutex> lock(mutex);
+    registered.push_back(texture);
+}
+
+void VirtualTextureCache::forget(const VirtualTexture& texture) {
+    for (size_t i = 0; i < texture.pageCount; ++i) {
+        if (!texture.pages[i].texels.data.empty()) {
+            residentBytes -= texture.pages[i].texels.data.size();
+            residentPages--;
+        }
+    }
+}
+
+void VirtualTextureCache::loaderThread() {
+    std::ifstream file;
+    std::string openFile;
+
+    while (true) {
+        LoadRequest request;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            condition.wait(lock, [this] { return stop || !requests.empty(); });
+            if (stop) return;
+            request = std::move(requests.front());
+            requests.pop_front();
+        }
+
+        LoadResult result{ request.texture, request.page, {} };
+        if (openFile != request.file) {
+            file.close();
+            file.clear();
+            file.open(request.file, std::ios::binary);
+            openFile = request.file;
+        }
+        if (file.is_open()) {
+            result.data.resize(request.bytes);
+            file.seekg(static_cast<std::streamoff>(request.offset));
+            file.read(reinterpret_cast<char*>(result.data.data()), request.bytes);
+            if (!file) {
+                result.data.clear();
+                file.clear();
+            }
+        }
+
+        std::unique_lock<std::mutex> lock(mutex);
+        results.push_back(std::move(result));
+    }
+}
+
+void VirtualTextureCache::evict(VirtualTexture& texture, size_t page) {
+    Texture::MipLevel& texels = texture.pages[page].texels;
+    residentBytes -= texels.data.size();
+    residentPages--;
+    pagesEvicted++;
+    texels.data = std::vector<unsigned char>(); // Release the memory
+}
+
+bool VirtualTextureCache::makeRoom(size_t bytes, std::vector<EvictionCandidate>& candidates, bool& candidatesBuilt) {
+    if (residentBytes + bytes <= budget) return true;
+
+    if (!candidatesBuilt) {
+        // Pages not used during the last frame, least recently used first
+        uint32_t currentFrame = frame.load(std::memory_order_relaxed);
+        for (const auto& weak : textures) {
+            auto texture = weak.lock();
+            if (!texture) continue;
+            for (size_t i = 0; i < texture->pageCount; ++i) {
+                const auto& page = texture->pages[i];
+                uint32_t lastUsed = page.lastUsedFrame.load(std::memory_order_relaxed);
+                if (!page.texels.data.empty() && lastUsed != currentFrame) {
+                    candidates.push_back({ lastUsed, texture.get(), i });
+                }
+            }
+        }
+        // Reverse order so the oldest page is popped from the back
+        std::sort(candidates.begin(), candidates.end(),
+                  [](const EvictionCandidate& a, const EvictionCandidate& b) { return a.lastUsedFrame > b.lastUsedFrame; });
+        candidatesBuilt = true;
+    }
+
+    while (residentBytes + bytes > budget && !candidates.empty()) {
+        EvictionCandidate candidate = candidates.back();
+        candidates.pop_back();
+        if (!candidate.texture->pages[candidate.page].texels.data.empty()) {
+            evict(*candidate.texture, candidate.page);
+        }
+    }
+    return residentBytes + bytes <= budget;
+}
+
+void VirtualTextureCache::update() {
+    uint32_t currentFrame = frame.load(std::memory_order_relaxed);
+
+    // Textures created since the last frame (possibly by loads on other threads)
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        textures.insert(textures.end(), registered.begin(), registered.end());
+        registered.clear();
+    }
+
+    // Keep every texture alive for the duration of the update, drop dead ones
+    std::vector<std::shared_ptr<VirtualTexture>> alive;
+    alive.reserve(textures.size());
+    textures.erase(std::remove_if(textures.begin(), textures.end(),
+                                  [&alive](const std::weak_ptr<VirtualTexture>& weak) {
+                                      auto texture = weak.lock();
+                                      if (!texture) return true;
+                                      alive.push_back(std::move(texture));
+                                      return false;
+                                  }),
+                   textures.end());
+
+    std::vector<EvictionCandidate> candidates;
+    bool candidatesBuilt = false;
+    makeRoom(0, candidates, candidatesBuilt); // The budget may have shrunk
+
+    // Install pages the loader finished since the last frame
+    std::vector<LoadResult> finished;
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        finished.swap(results);
+    }
+    for (auto& result : finished) {
+        auto texture = result.texture.lock();
+        if (!texture) continue;
+        auto& page = texture->pages[result.page];
+        page.pending = false;
+        if (result.data.empty()) {
+            std::cerr << "Error: Failed to read page " << result.page << " from " << texture->pageFile << std::endl;
+            continue;
+        }
+        // Budget full of pages that are still in use: drop it, the sampler asks again
+        if (!makeRoom(result.data.size(), candidates, candidatesBuilt)) continue;
+
+        page.texels.width = VirtualTexture::PageStride;
+        page.texels.height = VirtualTexture::PageStride;
+        page.texels.format = texture->getFormat();
+        page.texels.layout = TexelLayout::Linear;
+        page.texels.data = std::move(result.data);
+        page.lastUsedFrame.store(currentFrame, std::memory_order_relaxed);
+        residentBytes += page.texels.data.size();
+        residentPages++;
+        pagesLoaded++;
+    }
+
+    // Queue the pages requested during the last frame, coarse levels first so
+    // the fallback improves quickly while the fine pages are still loading
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        for (const auto& texture : alive) {
+            for (int level = static_cast<int>(texture->pagedLevels.size()) - 1; level >= 0; --level) {
+                const auto& paged = texture->pagedLevels[level];
+                size_t end = paged.firstPage + static_cast<size_t>(paged.pagesWide) * paged.pagesHigh;
+                for (size_t i = paged.firstPage; i < end && requests.size() < maxPendingLoads; ++i) {
+                    auto& page = texture->pages[i];
+                    if (page.pending || !page.texels.data.empty() ||
+                        page.requestedFrame.load(std::memory_order_relaxed) != currentFrame) continue;
+                    page.pending = true;
+                    requests.push_back({ texture, i, texture->pageFile, i * texture->pageBytes, texture->pageBytes });
+                }
+            }
+        }
+    }
+    condition.notify_one();
+
+    frame.store(currentFrame + 1, std::memory_order_relaxed);
+}
@@ -1,12 +1,19 @@
 // src/core/threadpool.cpp
 #include "core/threadpool.h"
 #include <iostream>
+#include <algorithm>
+#include <stdexcept>
+
+namespace {
+    thread_local const ThreadPool* currentPool = nullptr;
+    thread_local int currentWorkerIndex = -1;
+}
 
 // Constructor: Initializes the thread pool with a specified number of threads
 ThreadPool::ThreadPool(uint32_t numThreads) 
     : numThreads(numThreads), stop(false), activeTasks(0) {
     for (uint32_t i = 0; i < numThreads; ++i) {
-        workers.emplace_back(&ThreadPool::workerThread, this);
+        workers.emplace_back(&ThreadPool::workerThread, this, i);
     }
 }
 
@@ -34,15 +41,51 @@ void ThreadPool::enqueue(std::function<void()>&& task) {
     condition.notify_one();
 }
 
+int ThreadPool::getCurrentWorkerIndex() const {
+    return currentPool == this ? currentWorkerIndex : -1;
+}
+
 // Wait until all enqueued tasks are completed
 void ThreadPool::waitForCompletion() {
     std::unique_lock<std::mutex> lock(queueMutex);
     completionCondition.wait(lock, [this] { return activeTasks == 0 && tasks.empty(); });
 }
 
+void ThreadPool::parallelFor(int count, int grain, const std::function<void(int, int)>& body) {
+    if (count <= 0) return;
+    int chunks = std::min((count + std::max(1, grain) - 1) / std::max(1, grain), static_cast<int>(numThreads + 1) * 4);
+#ifndef MultiThreading
+    chunks = 1;
+#endif
+    if (chunks <= 1 || getCurrentWorkerIndex() >= 0) {
+        body(0, count);
+        return;
+    }
+
+    // Completion of this call only, unlike waitForCompletion()
+    std::mutex doneMutex;
+    std::condition_variable doneCondition;
+    int remaining = chunks - 1;
+    for (int i = 0; i < chunks - 1; ++i) {
+        int begin = static_cast<int>(static_cast<int64_t>(count) * i / chunks);
+        int end = static_cast<int>(static_cast<int64_t>(count) * (i + 1) / chunks);
+        enqueue([&, begin, end]() {
+            body(begin, end);
+            std::lock_guard<std::mutex> lock(doneMutex);
+            if (--remaining == 0) doneCondition.notify_one();
+        });
+    }
+    body(static_cast<int>(static_cast<int64_t>(count) * (chunks - 1) / chunks), count); // Last chunk on this thread
+
+    std::unique_lock<std::mutex> lock(doneMutex);
+    doneCondition.wait(lock, [&] { return remaining == 0; });
+}
+
 
 // Worker thread function that processes tasks from the queue
-void ThreadPool::workerThread() {
+void ThreadPool::workerThread(uint32_t index) {
+    currentPool = this;
+    currentWorkerIndex = static_cast<int>(index);
     while (true) {
         std::function<void()> task;
         {
@@ -0,0 +1,70 @@
+// src/io/cache_file.cpp
+#include "io/cache_file.h"
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+
+namespace { // Anonymous namespace for internal linkage helper functions
+
+    uint64_t fnv1a(const std::string& text) {
+        uint64_t hash = 14695981039346656037ull;
+        for (unsigned char c : text) {
+            hash ^= c;
+            hash *= 1099511628211ull;
+        }
+        return hash;
+    }
+
+} // end anonymous namespace
+
+namespace CacheFile {
+
+std::string sourceKey(const std::string& filename) {
+    std::error_code error;
+    std::filesystem::path absolute = std::filesystem::absolute(filename, error);
+    return error ? filename : absolute.generic_string();
+}
+
+bool sourceStamp(const std::string& filename, uint64_t& size, int64_t& time) {
+    std::error_code error;
+    size = std::filesystem::file_size(filename, error);
+    if (error) return false;
+    auto writeTime = std::filesystem::last_write_time(filename, error);
+    if (error) return false;
+    time = static_cast<int64_t>(writeTime.time_since_epoch().count());
+    return true;
+}
+
+std::string path(const std::string& cacheDirectory, const std::string& key, const std::string& extension) {
+    char name[20];
+    std::snprintf(name, sizeof(name), "%016llx", static_cast<unsigned long long>(fnv1a(key)));
+    return (std::filesystem::path(cacheDirectory) / (name + extension)).string();
+}
+
+bool writeAtomically(const std::string& path, const std::function<bool(std::ofstream&)>& write) {
+    std::error_code error;
+    std::filesystem::path directory = std::filesystem::path(path).parent_path();
+    if (!directory.empty()) {
+        std::filesystem::create_directories(directory, error);
+        if (error) return false;
+    }
+
+    std::string tempPath = path + ".tmp" + std::to_string(std::chrono::steady_clock::now().time_since_epoch().count());
+    {
+        std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+        if (!out) return false;
+        if (!write(out) || !out) {
+            out.close();
+            std::filesystem::remove(tempPath, error);
+            return false;
+        }
+    }
+    std::filesystem::rename(tempPath, path, error);
+    if (error) {
+        std::filesystem::remove(tempPath, error);
+        return false;
+    }
+    return true;
+}
+
+} // namespace CacheFile
@@ -0,0 +1,511 @@
+// src/io/gltf_reader.cpp
+#include "io/gltf_reader.h"
+#include "io/mapped_file.h"
+#include "core/model.h"
+#include <yaml-cpp/yaml.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <utility>
+
+namespace { // Anonymous namespace for internal linkage helper functions
+
+    constexpr uint32_t GlbMagic = 0x46546c67u;     // "glTF"
+    constexpr uint32_t GlbJsonChunk = 0x4e4f534au; // "JSON"
+    constexpr uint32_t GlbBinChunk = 0x004e4942u;  // "BIN\0"
+
+    enum ComponentType {
+        Byte = 5120, UnsignedByte = 5121, Short = 5122, UnsignedShort = 5123, UnsignedInt = 5125, Float = 5126
+    };
+    constexpr int TrianglesMode = 4;
+
+    // A buffer is either a range of a mapped file (GLB chunk, .bin file) or
+    // decoded from a data URI; only the former can back model streams
+    struct Buffer {
+        std::shared_ptr<const MappedFile> file;
+        std::vector<unsigned char> decoded;
+        const unsigned char* data = nullptr;
+        size_t size = 0;
+    };
+
+    // Elements of an accessor, bounds checked against their buffer
+    struct Accessor {
+        const Buffer* buffer = nullptr;
+        const unsigned char* data = nullptr;
+        size_t count = 0;
+        size_t stride = 0;
+        int componentType = 0;
+        int components = 0;
+        bool normalized = false;
+    };
+
+    int componentSize(int componentType) {
+        switch (componentType) {
+            case Byte: case UnsignedByte: return 1;
+            case Short: case UnsignedShort: return 2;
+            case UnsignedInt: case Float: return 4;
+            default: return 0;
+        }
+    }
+
+    int componentCount(const std::string& type) {
+        if (type == "SCALAR") return 1;
+        if (type == "VEC2") return 2;
+        if (type == "VEC3") return 3;
+        if (type == "VEC4") return 4;
+        return 0; // Matrices are not vertex attributes
+    }
+
+    // Normalized integers map to [0, 1] (unsigned) or [-1, 1] (signed)
+    inline float readComponent(const unsigned char* p, int componentType, bool normalized) {
+        switch (componentType) {
+            case Float: { float v; std::memcpy(&v, p, 4); return v; }
+            case UnsignedByte: return normalized ? *p / 255.0f : *p;
+            case Byte: { int8_t v = static_cast<int8_t>(*p); return normalized ? std::max(v / 127.0f, -1.0f) : v; }
+            case UnsignedShort: { uint16_t v; std::memcpy(&v, p, 2); return normalized ? v / 65535.0f : v; }
+            case Short: { int16_t v; std::memcpy(&v, p, 2); return normalized ? std::max(v / 32767.0f, -1.0f) : v; }
+            case UnsignedInt: { uint32_t v; std::memcpy(&v, p, 4); return static_cast<float>(v); }
+            default: return 0.0f;
+        }
+    }
+
+    inline uint32_t readIndex(const unsigned char* p, int componentType) {
+        switch (componentType) {
+            case UnsignedByte: return *p;
+            case UnsignedShort: { uint16_t v; std::memcpy(&v, p, 2); return v; }
+            default: { uint32_t v; std::memcpy(&v, p, 4); return v; }
+        }
+    }
+
+    bool decodeBase64(const std::string& text, std::vector<unsigned char>& out) {
+        auto value = [](char c) -> int {
+            if (c >= 'A' && c <= 'Z') return c - 'A';
+            if (c >= 'a' && c <= 'z') return c - 'a' + 26;
+            if (c >= '0' && c <= '9') return c - '0' + 52;
+            if (c == '+') return 62;
+            if (c == '/') return 63;
+            return -1;
+        };
+        out.clear();
+        out.reserve(text.size() * 3 / 4);
+        uint32_t bits = 0;
+        int numBits = 0;
+        for (char c : text) {
+            if (c == '=') break;
+            int v = value(c);
+            if (v < 0) return false;
+            bits = (bits << 6) | static_cast<uint32_t>(v);
+            numBits += 6;
+            if (numBits >= 8) {
+                numBits -= 8;
+                out.push_back(static_cast<unsigned char>(bits >> numBits));
+            }
+        }
+        return true;
+    }
+
+    class GltfParser {
+    public:
+        GltfParser(const std::string& filename, GltfAsset& asset) : filename(filename), asset(asset) {
+            directory = std::filesystem::path(filename).parent_path();
+        }
+
+        bool parse() {
+            std::shared_ptr<MappedFile> file = MappedFile::open(filename);
+            if (!file) return fail("cannot open file");
+
+            std::string json;
+            Buffer glbChunk;
+            uint32_t magic = 0;
+            if (file->size() >= 12) std::memcpy(&magic, file->data(), 4);
+            if (magic == GlbMagic) {
+                if (!readGlbChunks(file, json, glbChunk)) return false;
+            } else {
+                json.assign(reinterpret_cast<const char*>(file->data()), file->size());
+            }
+
+            // JSON is (practically) a subset of YAML: the scene file parser reads it
+            try {
+                root = YAML::Load(json);
+            } catch (const YAML::Exception& e) {
+                return fail(std::string("invalid JSON: ") + e.what());
+            }
+            if (!root.IsMap() || !root["asset"]) return fail("not a glTF asset");
+            std::string version = root["asset"]["version"] ? root["asset"]["version"].as<std::string>() : "";
+            if (version.empty() || version[0] != '2') return fail("unsupported glTF version " + version);
+
+            try {
+                return readBuffers(glbChunk) && readMaterials() && readNodes();
+            } catch (const YAML::Exception& e) {
+                return fail(std::string("malformed glTF: ") + e.what());
+            }
+        }
+
+    private:
+        bool fail(const std::string& reason) {
+            std::cerr << "Cannot read glTF file " << filename << ": " << reason << std::endl;
+            return false;
+        }
+
+        // 12-byte header, then the JSON chunk and an optional BIN chunk (4-byte aligned)
+        bool readGlbChunks(const std::shared_ptr<MappedFile>& file, std::string& json, Buffer& bin) {
+            const unsigned char* data = file->data();
+            uint32_t version, length;
+            std::memcpy(&version, data + 4, 4);
+            std::memcpy(&length, data + 8, 4);
+            if (version != 2 || length > file->size()) return fail("bad GLB header");
+            size_t offset = 12;
+            while (offset + 8 <= length) {
+                uint32_t chunkLength, chunkType;
+                std::memcpy(&chunkLength, data + offset, 4);
+                std::memcpy(&chunkType, data + offset + 4, 4);
+                offset += 8;
+                if (chunkLength > length - offset) return fail("truncated GLB chunk");
+                if (chunkType == GlbJsonChunk && json.empty()) {
+                    json.assign(reinterpret_cast<const char*>(data + offset), chunkLength);
+                } else if (chunkType == GlbBinChunk && !bin.data) {
+                    bin.file = file;
+                    bin.data = data + offset;
+                    bin.size = chunkLength;
+                }
+                offset += (chunkLength + 3) & ~3u;
+            }
+            if (json.empty()) return fail("GLB without JSON chunk");
+            return true;
+        }
+
+        bool readBuffers(const Buffer& glbChunk) {
+            for (const YAML::Node& node : root["buffers"]) {
+                Buffer buffer;
+                size_t byteLength = node["byteLength"].as<size_t>();
+                if (!node["uri"]) {
+                    if (!glbChunk.data) return fail("buffer without uri outside a GLB file");
+                    buffer = glbChunk;
+                } else {
+                    std::string uri = node["uri"].as<std::string>();
+                    if (uri.rfind("data:", 0) == 0) {
+                        size_t comma = uri.find(";base64,");
+                        if (comma == std::string::npos || !decodeBase64(uri.substr(comma + 8), buffer.decoded)) {
+                            return fail("unsupported data URI");
+                        }
+                        buffer.data = buffer.decoded.data();
+                        buffer.size = buffer.decoded.size();
+                    } else {
+                        buffer.file = MappedFile::open((directory / uri).string());
+                        if (!buffer.file) return fail("cannot open buffer " + uri);
+                        buffer.data = buffer.file->data();
+                        buffer.size = buffer.file->size();
+                    }
+                }
+                if (buffer.size < byteLength) return fail("buffer shorter than its byteLength");
+                buffer.size = byteLength;
+                buffers.push_back(std::move(buffer));
+            }
+            return true;
+        }
+
+        bool resolveAccessor(int index, Accessor& accessor) {
+            YAML::Node node = root["accessors"][index];
+            if (!node) return fail("accessor " + std::to_string(index) + " out of range");
+            if (node["sparse"]) return fail("sparse accessors are not supported");
+            accessor.componentType = node["componentType"].as<int>();
+            accessor.components = componentCount(node["type"].as<std::string>());
+            accessor.count = node["count"].as<size_t>();
+            accessor.normalized = node["normalized"] && node["normalized"].as<bool>();
+            size_t elementSize = static_cast<size_t>(componentSize(accessor.componentType)) * accessor.components;
+            if (elementSize == 0) return fail("unsupported accessor type");
+            if (!node["bufferView"]) return fail("accessors without buffer view are not supported");
+
+            YAML::Node view = root["bufferViews"][node["bufferView"].as<int>()];
+            if (!view) return fail("buffer view out of range");
+            size_t bufferIndex = view["buffer"].as<size_t>();
+            if (bufferIndex >= buffers.size()) return fail("buffer out of range");
+            const Buffer& buffer = buffers[bufferIndex];
+            size_t viewOffset = view["byteOffset"] ? view["byteOffset"].as<size_t>() : 0;
+            size_t viewLength = view["byteLength"].as<size_t>();
+            size_t offset = node["byteOffset"] ? node["byteOffset"].as<size_t>() : 0;
+            accessor.stride = view["byteStride"] ? view["byteStride"].as<size_t>() : elementSize;
+            if (viewOffset > buffer.size || viewLength > buffer.size - viewOffset || accessor.stride < elementSize ||
+                (accessor.count > 0 && (offset > viewLength || (accessor.count - 1) * accessor.stride + elementSize > viewLength - offset))) {
+                return fail("accessor " + std::to_string(index) + " exceeds its buffer");
+            }
+            accessor.buffer = &buffer;
+            accessor.data = buffer.data + viewOffset + offset;
+            return true;
+        }
+
+        // Maps the accessor as the stream if it has exactly the stream's layout,
+        // otherwise converts it element by element
+        template <typename T, int N>
+        bool readFloatStream(int index, MeshArray<T>& stream, bool flipV = false) {
+            Accessor accessor;
+            if (!resolveAccessor(index, accessor)) return false;
+            if (accessor.components != N) return fail("unexpected attribute type");
+            if (!flipV && accessor.componentType == Float && accessor.stride == sizeof(T) && accessor.buffer->file &&
+                reinterpret_cast<uintptr_t>(accessor.data) % alignof(T) == 0) {
+                stream = MeshArray<T>::mapped(accessor.buffer->file, reinterpret_cast<const T*>(accessor.data), accessor.count);
+                mappedStreams++;
+                return true;
+            }
+            std::vector<T> elements(accessor.count);
+            const int size = componentSize(accessor.componentType);
+            for (size_t i = 0; i < accessor.count; ++i) {
+                const unsigned char* p = accessor.data + i * accessor.stride;
+                float* out = reinterpret_cast<float*>(&elements[i]);
+                for (int c = 0; c < N; ++c) out[c] = readComponent(p + c * size, accessor.componentType, accessor.normalized);
+            }
+            if constexpr (N == 2) {
+                if (flipV) {
+                    for (T& uv : elements) uv.y = 1.0f - uv.y;
+                }
+            }
+            stream = std::move(elements);
+            return true;
+        }
+
+        bool readIndices(int index, size_t numVertices, MeshArray<uint32_t>& indices) {
+            Accessor accessor;
+            if (!resolveAccessor(index, accessor)) return false;
+            if (accessor.components != 1 || (accessor.componentType != UnsignedByte && accessor.componentType != UnsignedShort &&
+                                              accessor.componentType != UnsignedInt)) {
+                return fail("unexpected index type");
+            }
+            size_t numIndices = accessor.count - accessor.count % 3;
+            if (accessor.componentType == UnsignedInt && accessor.stride == 4 && accessor.buffer->file &&
+                reinterpret_cast<uintptr_t>(accessor.data) % 4 == 0) {
+                indices = MeshArray<uint32_t>::mapped(accessor.buffer->file, reinterpret_cast<const uint32_t*>(accessor.data), numIndices);
+                mappedStreams++;
+            } else {
+                std::vector<uint32_t> widened(numIndices);
+                for (size_t i = 0; i < numIndices; ++i) widened[i] = readIndex(accessor.data + i * accessor.stride, accessor.componentType);
+                indices = std::move(widened);
+            }
+            // The renderer does not check indices: validate them once here
+            if (!indices.empty() && *std::max_element(indices.begin(), indices.end()) >= numVertices) {
+                return fail("vertex index out of range");
+            }
+            return true;
+        }
+
+        // Bitangent = w * cross(normal, tangent), w being the handedness
+        bool readTangents(int index, Model& model) {
+            MeshArray<vec4f> tangents;
+            if (!readFloatStream<vec4f, 4>(index, tangents)) return false;
+            if (tangents.isMapped()) mappedStreams--; // Converted below
+            if (tangents.size() != model.vertices.size() || model.normals.size() != model.vertices.size()) {
+                return fail("TANGENT count differs from POSITION");
+            }
+            std::vector<vec3f> t(tangents.size()), b(tangents.size());
+            for (size_t i = 0; i < tangents.size(); ++i) {
+                const vec4f& tangent = std::as_const(tangents)[i];
+                t[i] = vec3f(tangent.x, tangent.y, tangent.z);
+                b[i] = std::as_const(model.normals)[i].cross(t[i]) * (tangent.w < 0.0f ? -1.0f : 1.0f);
+            }
+            model.tangents = std::move(t);
+            model.bitangents = std::move(b);
+            return true;
+        }
+
+        bool readPrimitive(const YAML::Node& primitive, std::shared_ptr<Model>& model) {
+            YAML::Node attributes = primitive["attributes"];
+            if (!attributes || !attributes["POSITION"]) return fail("primitive without POSITION");
+            model = std::make_shared<Model>();
+
+            int positionAccessor = attributes["POSITION"].as<int>();
+            if (!readFloatStream<vec3f, 3>(positionAccessor, model->vertices)) return false;
+            const size_t numVertices = model->vertices.size();
+            if (attributes["NORMAL"] && !readFloatStream<vec3f, 3>(attributes["NORMAL"].as<int>(), model->normals)) return false;
+            if (attributes["TEXCOORD_0"] && !readFloatStream<vec2f, 2>(attributes["TEXCOORD_0"].as<int>(), model->uvs, true)) return false;
+            if (primitive["indices"]) {
+                if (!readIndices(primitive["indices"].as<int>(), numVertices, model->indices)) return false;
+            } else {
+                std::vector<uint32_t> sequential(numVertices - numVertices % 3);
+                for (size_t i = 0; i < sequential.size(); ++i) sequential[i] = static_cast<uint32_t>(i);
+                model->indices = std::move(sequential);
+            }
+            if (model->normals.size() != numVertices || model->uvs.size() != numVertices) {
+                if (!model->normals.empty() && model->normals.size() != numVertices) return fail("NORMAL count differs from POSITION");
+                if (!model->uvs.empty() && model->uvs.size() != numVertices) return fail("TEXCOORD_0 count differs from POSITION");
+                if (model->normals.empty()) model->normals = smoothNormals(*model);
+                if (model->uvs.empty()) model->uvs.assign(numVertices, vec2f(0.0f, 0.0f));
+            }
+            if (attributes["TANGENT"] && !readTangents(attributes["TANGENT"].as<int>(), *model)) return false;
+
+            // POSITION accessors must have min and max: no pass over the vertices
+            YAML::Node accessor = root["accessors"][positionAccessor];
+            if (accessor["min"] && accessor["max"] && accessor["min"].size() == 3 && accessor["max"].size() == 3) {
+                model->boundsMin = accessor["min"].as<std::vector<float>>();
+                model->boundsMax = accessor["max"].as<std::vector<float>>();
+                model->boundsRadius = std::sqrt((model->boundsMax - model->boundsMin).lengthSq()) * 0.5f;
+            } else {
+                model->calculateBounds();
+            }
+            return true;
+        }
+
+        // Area weighted vertex normals, for primitives without NORMAL (the
+        // specification asks for flat normals, which would need unwelding)
+        static std::vector<vec3f> smoothNormals(const Model& model) {
+            std::vector<vec3f> normals(model.vertices.size(), vec3f(0.0f, 0.0f, 0.0f));
+            for (size_t i = 0; i < model.numFaces(); ++i) {
+                const uint32_t* triangle = model.getTriangle(i);
+                const vec3f& v0 = model.vertices[triangle[0]];
+                vec3f faceNormal = (model.vertices[triangle[1]] - v0).cross(model.vertices[triangle[2]] - v0);
+                for (int c = 0; c < 3; ++c) normals[triangle[c]] += faceNormal;
+            }
+            for (vec3f& n : normals) n = n.lengthSq() > 0.0f ? n.normalized() : vec3f(0.0f, 1.0f, 0.0f);
+            return normals;
+        }
+
+        // Image file of a texture reference, empty if it has none or the image is embedded
+        std::string texturePath(const YAML::Node& textureInfo) {
+            if (!textureInfo || !textureInfo["index"]) return "";
+            YAML::Node texture = root["textures"][textureInfo["index"].as<int>()];
+            if (!texture || !texture["source"]) return "";
+            YAML::Node image = root["images"][texture["source"].as<int>()];
+            if (!image || !image["uri"]) return "";
+            std::string uri = image["uri"].as<std::string>();
+            if (uri.rfind("data:", 0) == 0) return "";
+            return (directory / uri).string();
+        }
+
+        bool readMaterials() {
+            for (const YAML::Node& node : root["materials"]) {
+                GltfMaterial material;
+                if (node["name"]) material.name = node["name"].as<std::string>();
+                YAML::Node pbr = node["pbrMetallicRoughness"];
+                if (pbr) {
+                    if (pbr["baseColorFactor"]) {
+                        std::vector<float> factor = pbr["baseColorFactor"].as<std::vector<float>>();
+                        if (factor.size() == 4) material.baseColorFactor = vec4f(factor[0], factor[1], factor[2], factor[3]);
+                    }
+                    if (pbr["metallicFactor"]) material.metallicFactor = pbr["metallicFactor"].as<float>();
+                    if (pbr["roughnessFactor"]) material.roughnessFactor = pbr["roughnessFactor"].as<float>();
+                    material.baseColorTexture = texturePath(pbr["baseColorTexture"]);
+                    material.metallicRoughnessTexture = texturePath(pbr["metallicRoughnessTexture"]);
+                }
+                material.normalTexture = texturePath(node["normalTexture"]);
+                material.occlusionTexture = texturePath(node["occlusionTexture"]);
+                asset.materials.push_back(std::move(material));
+            }
+            return true;
+        }
+
+        // TRS, or a column-major matrix decomposed into translation, rotation and (positive) scale
+        static Transform nodeTransform(const YAML::Node& node) {
+            Transform transform;
+            if (node["matrix"]) {
+                std::vector<float> m = node["matrix"].as<std::vector<float>>();
+                if (m.size() != 16) return transform;
+                vec3f axes[3] = {vec3f(m[0], m[1], m[2]), vec3f(m[4], m[5], m[6]), vec3f(m[8], m[9], m[10])};
+                vec3f scale(std::sqrt(axes[0].lengthSq()), std::sqrt(axes[1].lengthSq()), std::sqrt(axes[2].lengthSq()));
+                for (int i = 0; i < 3; ++i) {
+                    float s = i == 0 ? scale.x : (i == 1 ? scale.y : scale.z);
+                    if (s > 0.0f) axes[i] = axes[i] * (1.0f / s);
+                }
+                transform.setPosition(vec3f(m[12], m[13], m[14]));
+                transform.setScale(scale);
+                transform.setRotation(rotationFromAxes(axes));
+                return transform;
+            }
+            if (node["translation"]) transform.setPosition(node["translation"].as<std::vector<float>>());
+            if (node["rotation"]) {
+                std::vector<float> q = node["rotation"].as<std::vector<float>>(); // x, y, z, w
+                if (q.size() == 4) transform.setRotation(quat(q[3], q[0], q[1], q[2]));
+            }
+            if (node["scale"]) transform.setScale(node["scale"].as<std::vector<float>>());
+            return transform;
+        }
+
+        // Quaternion of an orthonormal basis (columns), Shepperd's method
+        static quat rotationFromAxes(const vec3f (&c)[3]) {
+            float trace = c[0].x + c[1].y + c[2].z;
+            if (trace > 0.0f) {
+                float s = std::sqrt(trace + 1.0f) * 2.0f;
+                return quat(0.25f * s, (c[1].z - c[2].y) / s, (c[2].x - c[0].z) / s, (c[0].y - c[1].x) / s);
+            }
+            if (c[0].x > c[1].y && c[0].x > c[2].z) {
+                float s = std::sqrt(1.0f + c[0].x - c[1].y - c[2].z) * 2.0f;
+                return quat((c[1].z - c[2].y) / s, 0.25f * s, (c[1].x + c[0].y) / s, (c[2].x + c[0].z) / s);
+            }
+            if (c[1].y > c[2].z) {
+                float s = std::sqrt(1.0f + c[1].y - c[0].x - c[2].z) * 2.0f;
+                return quat((c[2].x - c[0].z) / s, (c[1].x + c[0].y) / s, 0.25f * s, (c[2].y + c[1].z) / s);
+            }
+            float s = std::sqrt(1.0f + c[2].z - c[0].x - c[1].y) * 2.0f;
+            return quat((c[0].y - c[1].x) / s, (c[2].x + c[0].z) / s, (c[2].y + c[1].z) / s, 0.25f * s);
+        }
+
+        bool addMesh(int meshIndex, const Transform& transform) {
+            YAML::Node mesh = root["meshes"][meshIndex];
+            if (!mesh) return fail("mesh " + std::to_string(meshIndex) + " out of range");
+            int primitiveIndex = 0;
+            for (const YAML::Node& primitive : mesh["primitives"]) {
+                int mode = primitive["mode"] ? primitive["mode"].as<int>() : TrianglesMode;
+                if (mode != TrianglesMode) {
+                    std::cout << " Skipping glTF primitive with mode " << mode << " (only triangle lists are drawn)" << std::endl;
+                    ++primitiveIndex;
+                    continue;
+                }
+                std::shared_ptr<Model>& model = meshModels[{meshIndex, primitiveIndex++}];
+                if (!model && !readPrimitive(primitive, model)) return false;
+
+                GltfPrimitive instance;
+                instance.model = model;
+                instance.material = primitive["material"] ? primitive["material"].as<int>() : -1;
+                if (instance.material >= static_cast<int>(asset.materials.size())) instance.material = -1;
+                instance.transform = transform;
+                asset.primitives.push_back(std::move(instance));
+            }
+            return true;
+        }
+
+        bool addNode(int nodeIndex, const Transform& parent, int depth) {
+            YAML::Node node = root["nodes"][nodeIndex];
+            if (!node || depth > 64) return fail("bad node hierarchy");
+            Transform world = nodeTransform(node).combine(parent);
+            if (node["mesh"] && !addMesh(node["mesh"].as<int>(), world)) return false;
+            for (const YAML::Node& child : node["children"]) {
+                if (!addNode(child.as<int>(), world, depth + 1)) return false;
+            }
+            return true;
+        }
+
+        bool readNodes() {
+            YAML::Node scenes = root["scenes"];
+            if (!scenes || scenes.size() == 0) {
+                for (size_t mesh = 0; mesh < root["meshes"].size(); ++mesh) {
+                    if (!addMesh(static_cast<int>(mesh), Transform())) return false;
+                }
+            } else {
+                YAML::Node scene = scenes[root["scene"] ? root["scene"].as<int>() : 0];
+                if (!scene) return fail("default scene out of range");
+                for (const YAML::Node& node : scene["nodes"]) {
+                    if (!addNode(node.as<int>(), Transform(), 0)) return false;
+                }
+            }
+            std::cout << " glTF streams mapped without copying: " << mappedStreams << std::endl;
+            return true;
+        }
+
+        const std::string& filename;
+        GltfAsset& asset;
+        std::filesystem::path directory;
+        YAML::Node root;
+        std::vector<Buffer> buffers;
+        std::map<std::pair<int, int>, std::shared_ptr<Model>> meshModels; // (mesh, primitive)
+        size_t mappedStreams = 0;
+    };
+
+} // end anonymous namespace
+
+bool readGltf(const std::string& filename, GltfAsset& asset) {
+    asset = GltfAsset();
+    GltfParser parser(filename, asset);
+    return parser.parse();
+}
@@ -0,0 +1,281 @@
+// src/io/obj_reader.cpp
+#include "io/obj_reader.h"
+#include "io/mapped_file.h"
+#include "core/model.h"
+#include "core/threadpool.h"
+#include <algorithm>
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <vector>
+
+namespace { // Anonymous namespace for internal linkage helper functions
+
+    constexpr size_t ChunkBytes = 4 << 20; // Parse task size when running on a pool
+
+    // Element counts of a chunk, then the offsets of its elements in the model
+    struct ObjCounts {
+        size_t positions = 0;
+        size_t uvs = 0;
+        size_t normals = 0;
+        size_t triangles = 0;
+    };
+
+    // One line-aligned piece of the file. A counting pass sizes the model, so
+    // the parse pass writes every element straight to its final place.
+    struct ObjChunk {
+        const char* begin = nullptr;
+        const char* end = nullptr;
+        ObjCounts counts;
+        ObjCounts offsets;
+        std::string error;
+    };
+
+    enum class Statement { Other, Position, UV, Normal, Face };
+
+    inline bool isBlank(char c) { return c == ' ' || c == '\t' || c == '\r'; }
+
+    inline const char* skipBlanks(const char* p, const char* end) {
+        while (p < end && isBlank(*p)) ++p;
+        return p;
+    }
+
+    // Plain decimals ("-0.123456", the bulk of any OBJ file) are parsed directly
+    // in float: a mantissa up to 2^24 and a power of ten up to 1e10 are both exact
+    // floats, so their quotient is the correctly rounded result. Exponents, longer
+    // mantissas, inf and nan go through from_chars.
+    inline bool parseFloat(const char*& p, const char* end, float& value) {
+        static constexpr float powersOf10[11] = {1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f, 1e10f};
+        p = skipBlanks(p, end);
+        const char* q = p;
+        bool negative = q < end && *q == '-';
+        if (q < end && (*q == '-' || *q == '+')) ++q;
+        uint64_t mantissa = 0;
+        int digits = 0, fractionDigits = 0;
+        const char* digitsStart = q;
+        while (q < end && static_cast<unsigned>(*q - '0') < 10) {
+            mantissa = mantissa * 10 + static_cast<unsigned>(*q - '0');
+            ++q;
+            ++digits;
+        }
+        if (q < end && *q == '.') {
+            ++q;
+            while (q < end && static_cast<unsigned>(*q - '0') < 10) {
+                mantissa = mantissa * 10 + static_cast<unsigned>(*q - '0');
+                ++q;
+                ++digits;
+                ++fractionDigits;
+            }
+        }
+        bool plain = digits > 0 && digits <= 19 && mantissa <= (1u << 24) && fractionDigits <= 10 && (q >= end || (*q != 'e' && *q != 'E'));
+        if (!plain) {
+            if (digitsStart != p && *p == '+') ++p; // from_chars does not take a leading '+'
+            auto result = std::from_chars(p, end, value);
+            if (result.ec != std::errc()) return false;
+            p = result.ptr;
+            return true;
+        }
+        float magnitude = static_cast<float>(mantissa) / powersOf10[fractionDigits];
+        value = negative ? -magnitude : magnitude;
+        p = q;
+        return true;
+    }
+
+    inline Statement classify(const char* line, const char* lineEnd) {
+        if (lineEnd - line < 2) return Statement::Other; // Empty (no statement is shorter than "f 1 2 3")
+        if (line[0] == 'v') {
+            if (isBlank(line[1])) return Statement::Position;
+            if (line[1] == 't') return Statement::UV;
+            if (line[1] == 'n') return Statement::Normal;
+        } else if (line[0] == 'f' && isBlank(line[1])) {
+            return Statement::Face;
+        }
+        return Statement::Other; // Comments, groups, materials, smoothing groups, lines and points
+    }
+
+    // Calls body(statement, line, lineEnd) for every line of the chunk, until it returns false
+    template <typename Body>
+    void forEachLine(const ObjChunk& chunk, Body&& body) {
+        const char* p = chunk.begin;
+        while (p < chunk.end) {
+            const char* lineEnd = static_cast<const char*>(std::memchr(p, '\n', static_cast<size_t>(chunk.end - p)));
+            if (!lineEnd) lineEnd = chunk.end;
+            const char* line = skipBlanks(p, lineEnd);
+            p = lineEnd + 1;
+            if (!body(classify(line, lineEnd), line, lineEnd)) return;
+        }
+    }
+
+    void countChunk(ObjChunk& chunk) {
+        forEachLine(chunk, [&chunk](Statement statement, const char* line, const char* lineEnd) {
+            switch (statement) {
+                case Statement::Position: chunk.counts.positions++; break;
+                case Statement::UV:       chunk.counts.uvs++; break;
+                case Statement::Normal:   chunk.counts.normals++; break;
+                case Statement::Face: {
+                    size_t corners = 0;
+                    for (const char* q = line + 1; q < lineEnd; ++q) corners += isBlank(q[-1]) && !isBlank(q[0]);
+                    if (corners >= 3) chunk.counts.triangles += corners - 2; // Fan triangulated
+                    break;
+                }
+                default: break;
+            }
+            return true;
+        });
+    }
+
+    // OBJ index (1-based, or negative = counted back from the last element so far) to 0-based
+    inline bool resolveIndex(const char*& p, const char* end, size_t parsedSoFar, size_t total, int& index) {
+        // Digits are parsed inline: indices are most of a face line
+        bool negative = p < end && *p == '-';
+        if (negative || (p < end && *p == '+')) ++p;
+        long long raw = 0;
+        const char* digits = p;
+        while (p < end && static_cast<unsigned>(*p - '0') < 10 && p - digits < 18) raw = raw * 10 + (*p++ - '0');
+        if (p == digits || raw == 0) return false;
+        long long resolved = negative ? static_cast<long long>(parsedSoFar) - raw : raw - 1;
+        if (resolved < 0 || resolved >= static_cast<long long>(total)) return false;
+        index = static_cast<int>(resolved);
+        return true;
+    }
+
+    struct Corner {
+        int position;
+        int uv = -1;
+        int normal = -1;
+    };
+
+    bool parseFace(const char* p, const char* end, const ObjCounts& parsed, const ObjCounts& totals, std::vector<Corner>& corners,
+                   Model::Face*& out, Model::Face* outEnd) {
+        corners.clear();
+        while (true) {
+            p = skipBlanks(p, end);
+            if (p >= end) break;
+            Corner corner;
+            if (!resolveIndex(p, end, parsed.positions, totals.positions, corner.position)) return false;
+            if (p < end && *p == '/') {
+                ++p;
+                if (p < end && *p != '/' && !resolveIndex(p, end, parsed.uvs, totals.uvs, corner.uv)) return false;
+                if (p < end && *p == '/') {
+                    ++p;
+                    if (!resolveIndex(p, end, parsed.normals, totals.normals, corner.normal)) return false;
+                }
+            }
+            if (p < end && !isBlank(*p)) return false;
+            corners.push_back(corner);
+        }
+        if (corners.size() < 3 || outEnd - out < static_cast<ptrdiff_t>(corners.size() - 2)) return false;
+
+        // Fan triangulation (0, i, i + 1)
+        for (size_t i = 1; i + 1 < corners.size(); ++i, ++out) {
+            const Corner* triangle[3] = {&corners[0], &corners[i], &corners[i + 1]};
+            for (int c = 0; c < 3; ++c) {
+                out->vertIndex[c] = triangle[c]->position;
+                out->uvIndex[c] = triangle[c]->uv;
+                out->normIndex[c] = triangle[c]->normal;
+            }
+        }
+        return true;
+    }
+
+    void parseChunk(ObjChunk& chunk, Model& model, const ObjCounts& totals) {
+        // Elements before this chunk count for relative indices
+        ObjCounts parsed = chunk.offsets;
+        Model::Face* faces = model.faces.data() + chunk.offsets.triangles;
+        Model::Face* facesEnd = faces + chunk.counts.triangles;
+        std::vector<Corner> corners;
+        forEachLine(chunk, [&](Statement statement, const char* line, const char* lineEnd) {
+            const char* q = line + 2;
+            bool ok = true;
+            switch (statement) {
+                case Statement::Position: {
+                    vec3f& v = model.vertices[parsed.positions++];
+                    ok = parseFloat(q, lineEnd, v.x) && parseFloat(q, lineEnd, v.y) && parseFloat(q, lineEnd, v.z); // Optional w / colors ignored
+                    break;
+                }
+                case Statement::UV: {
+                    vec2f& vt = model.uvs[parsed.uvs++];
+                    vt = vec2f(0.0f, 0.0f);
+                    ok = parseFloat(q, lineEnd, vt.x);
+                    if (ok && skipBlanks(q, lineEnd) < lineEnd) ok = parseFloat(q, lineEnd, vt.y);
+                    break;
+                }
+                case Statement::Normal: {
+                    vec3f& vn = model.normals[parsed.normals++];
+                    ok = parseFloat(q, lineEnd, vn.x) && parseFloat(q, lineEnd, vn.y) && parseFloat(q, lineEnd, vn.z);
+                    break;
+                }
+                case Statement::Face:
+                    ok = parseFace(q, lineEnd, parsed, totals, corners, faces, facesEnd);
+                    break;
+                default:
+                    break;
+            }
+            if (!ok) chunk.error = std::string(line, static_cast<size_t>(std::min<ptrdiff_t>(lineEnd - line, 80)));
+            return ok;
+        });
+    }
+
+} // end anonymous namespace
+
+bool readObj(const std::string& filename, Model& model, ThreadPool* pool) {
+    std::shared_ptr<MappedFile> file = MappedFile::open(filename);
+    if (!file) {
+        std::cerr << "Cannot open OBJ file: " << filename << std::endl;
+        return false;
+    }
+    const char* data = reinterpret_cast<const char*>(file->data());
+    const size_t size = file->size();
+
+    // Chunks start after a newline, so every line belongs to exactly one chunk
+    size_t numChunks = pool ? std::max<size_t>(1, size / ChunkBytes) : 1;
+    std::vector<ObjChunk> chunks(numChunks);
+    for (size_t i = 0; i < numChunks; ++i) {
+        const char* begin = data + size * i / numChunks;
+        if (i > 0) {
+            const char* newline = static_cast<const char*>(std::memchr(begin, '\n', static_cast<size_t>(data + size - begin)));
+            begin = newline ? newline + 1 : data + size;
+        }
+        chunks[i].begin = begin;
+        if (i > 0) chunks[i - 1].end = std::max(chunks[i - 1].begin, begin);
+    }
+    chunks.back().end = data + size;
+
+    auto runChunks = [&](const std::function<void(ObjChunk&)>& task) {
+        auto body = [&](int begin, int end) {
+            for (int i = begin; i < end; ++i) task(chunks[i]);
+        };
+        if (pool) pool->parallelFor(static_cast<int>(numChunks), 1, body);
+        else body(0, static_cast<int>(numChunks));
+    };
+
+    // Pass 1: count, so each chunk knows where its elements go
+    runChunks(countChunk);
+    ObjCounts totals;
+    for (ObjChunk& chunk : chunks) {
+        chunk.offsets = totals;
+        totals.positions += chunk.counts.positions;
+        totals.uvs += chunk.counts.uvs;
+        totals.normals += chunk.counts.normals;
+        totals.triangles += chunk.counts.triangles;
+    }
+    model.vertices.assign(totals.positions, vec3f(0.0f, 0.0f, 0.0f));
+    model.uvs.assign(totals.uvs, vec2f(0.0f, 0.0f));
+    model.normals.assign(totals.normals, vec3f(0.0f, 0.0f, 0.0f));
+    model.faces.assign(totals.triangles, Model::Face());
+    model.tangents.clear();
+    model.bitangents.clear();
+    model.indices.clear();
+
+    // Pass 2: parse in place
+    runChunks([&](ObjChunk& chunk) { parseChunk(chunk, model, totals); });
+    for (const ObjChunk& chunk : chunks) {
+        if (!chunk.error.empty()) {
+            std::cerr << "Malformed OBJ statement (or index out of range) in " << filename << ": " << chunk.error << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
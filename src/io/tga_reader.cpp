@@ -0,0 +1,161 @@
+// src/io/tga_reader.cpp
+#include "io/tga_reader.h"
+#include "io/tga_writer.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+
+#ifndef NaiveMethod
+#include <immintrin.h>
+#endif
+
+namespace { // Anonymous namespace for internal linkage helper functions
+
+    // Writes `count` copies of one pixel (an RLE run)
+    void fillPixels(unsigned char* dst, const unsigned char* pixel, int count, int bytesPerPixel) {
+        if (bytesPerPixel == 1) {
+            std::memset(dst, pixel[0], static_cast<size_t>(count));
+            return;
+        }
+#ifndef NaiveMethod
+        if (bytesPerPixel == 4) {
+            uint32_t value;
+            std::memcpy(&value, pixel, 4);
+            __m128i pattern = _mm_set1_epi32(static_cast<int>(value));
+            int i = 0;
+            for (; i + 4 <= count; i += 4) _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i * 4), pattern);
+            dst += i * 4;
+            count -= i;
+        } else if (count >= 16) {
+            // 16 BGR pixels are 48 bytes: three registers of the repeating pattern
+            alignas(16) unsigned char pattern[48];
+            for (int i = 0; i < 16; ++i) std::memcpy(pattern + 3 * i, pixel, 3);
+            __m128i p0 = _mm_load_si128(reinterpret_cast<const __m128i*>(pattern));
+            __m128i p1 = _mm_load_si128(reinterpret_cast<const __m128i*>(pattern + 16));
+            __m128i p2 = _mm_load_si128(reinterpret_cast<const __m128i*>(pattern + 32));
+            int i = 0;
+            for (; i + 16 <= count; i += 16) {
+                __m128i* out = reinterpret_cast<__m128i*>(dst + i * 3);
+                _mm_storeu_si128(out, p0);
+                _mm_storeu_si128(out + 1, p1);
+                _mm_storeu_si128(out + 2, p2);
+            }
+            dst += i * 3;
+            count -= i;
+        }
+#endif
+        for (int i = 0; i < count; ++i) std::memcpy(dst + i * bytesPerPixel, pixel, static_cast<size_t>(bytesPerPixel));
+    }
+
+    void mirrorRow(unsigned char* row, int width, int bytesPerPixel) {
+        for (int left = 0, right = width - 1; left < right; ++left, --right) {
+            std::swap_ranges(row + left * bytesPerPixel, row + (left + 1) * bytesPerPixel, row + right * bytesPerPixel);
+        }
+    }
+
+} // end anonymous namespace
+
+bool TGAReader::open(const std::string& name) {
+    filename = name;
+    file = MappedFile::open(name);
+    if (!file || file->size() < sizeof(TGAHeader)) {
+        std::cerr << "Cannot open TGA file: " << name << std::endl;
+        return false;
+    }
+
+    TGAHeader header;
+    std::memcpy(&header, file->data(), sizeof(header));
+    int type = static_cast<unsigned char>(header.datatypecode);
+    int bits = static_cast<unsigned char>(header.bitsperpixel);
+    bool trueColor = type == 2 || type == 10;
+    bool grayscale = type == 3 || type == 11;
+    if (!((trueColor && (bits == 24 || bits == 32)) || (grayscale && bits == 8))) {
+        std::cerr << "Unsupported TGA format (type " << type << ", " << bits << " bpp): " << name << std::endl;
+        return false;
+    }
+
+    width = static_cast<uint16_t>(header.width);
+    height = static_cast<uint16_t>(header.height);
+    bytesPerPixel = bits / 8;
+    rle = type >= 9;
+    topToBottom = (header.imagedescriptor & 0x20) != 0;
+    rightToLeft = (header.imagedescriptor & 0x10) != 0;
+
+    // Image ID and the (unused) color map come before the pixels
+    pixelOffset = sizeof(TGAHeader) + static_cast<unsigned char>(header.idlength);
+    if (header.colormaptype != 0) {
+        pixelOffset += static_cast<size_t>(static_cast<uint16_t>(header.colormaplength)) *
+                       ((static_cast<unsigned char>(header.colormapdepth) + 7) / 8);
+    }
+    size_t rawSize = static_cast<size_t>(width) * height * bytesPerPixel;
+    if (width == 0 || height == 0 || pixelOffset > file->size() || (!rle && file->size() - pixelOffset < rawSize)) {
+        std::cerr << "Truncated or empty TGA file: " << name << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool TGAReader::decodeRows(const std::function<void(int y, const unsigned char* pixels)>& consumer) const {
+    if (!file) return false;
+    std::vector<unsigned char> row;
+    if (rle || rightToLeft) row.resize(static_cast<size_t>(width) * bytesPerPixel);
+    if (rle) return decodeRLE(consumer, row);
+
+    const size_t rowBytes = static_cast<size_t>(width) * bytesPerPixel;
+    const unsigned char* pixels = file->data() + pixelOffset;
+    for (int fileRow = 0; fileRow < height; ++fileRow) {
+        const unsigned char* src = pixels + fileRow * rowBytes;
+        if (rightToLeft) {
+            std::memcpy(row.data(), src, rowBytes);
+            mirrorRow(row.data(), width, bytesPerPixel);
+            src = row.data();
+        }
+        consumer(topToBottom ? height - 1 - fileRow : fileRow, src);
+    }
+    return true;
+}
+
+bool TGAReader::decodeRLE(const std::function<void(int y, const unsigned char* pixels)>& consumer, std::vector<unsigned char>& row) const {
+    const unsigned char* src = file->data() + pixelOffset;
+    const unsigned char* end = file->data() + file->size();
+    const unsigned char* runPixel = nullptr;
+    int packetLeft = 0; // Packets may continue across rows
+    bool run = false;
+
+    for (int fileRow = 0; fileRow < height; ++fileRow) {
+        unsigned char* dst = row.data();
+        int x = 0;
+        while (x < width) {
+            if (packetLeft == 0) {
+                if (src >= end) break;
+                unsigned char packet = *src++;
+                run = (packet & 0x80) != 0;
+                packetLeft = (packet & 0x7F) + 1;
+                if (run) {
+                    if (end - src < bytesPerPixel) break;
+                    runPixel = src;
+                    src += bytesPerPixel;
+                }
+            }
+            int count = std::min(packetLeft, width - x);
+            if (run) {
+                fillPixels(dst + static_cast<size_t>(x) * bytesPerPixel, runPixel, count, bytesPerPixel);
+            } else {
+                size_t bytes = static_cast<size_t>(count) * bytesPerPixel;
+                if (static_cast<size_t>(end - src) < bytes) break;
+                std::memcpy(dst + static_cast<size_t>(x) * bytesPerPixel, src, bytes);
+                src += bytes;
+            }
+            x += count;
+            packetLeft -= count;
+        }
+        if (x < width) {
+            std::cerr << "Truncated RLE pixel data at row " << fileRow << " in TGA file: " << filename << std::endl;
+            return false;
+        }
+        if (rightToLeft) mirrorRow(dst, width, bytesPerPixel);
+        consumer(topToBottom ? height - 1 - fileRow : fileRow, dst);
+    }
+    return true;
+}
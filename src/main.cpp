@@ -2,12 +2,37 @@
 #include <iostream>
 #include "core/sdl_app.h"
 #include "core/scene.h"
+#include "core/resource_manager.h"
+#include "core/threadpool.h"
+#include <algorithm>
+
+int bench_texture_sampling(); // src/test.cpp
 
 int main(int argc, char* argv[]) {
     const int width = 800;
     const int height = 800;
     const std::string title = "Software Rasterizer (Refactored)";
 
+    // Offline: fill the texture cache of a scene without opening a window
+    if (argc > 1 && std::string(argv[1]) == "--bake-textures") {
+        std::string scenePath = argc > 2 ? argv[2] : "scenes/scene.yaml";
+        ThreadPool threadPool(std::max(1u, std::thread::hardware_concurrency()));
+        ResourceManager resourceManager;
+        resourceManager.setWorkerPool(&threadPool);
+        Scene scene(width, height, resourceManager);
+        if (!scene.loadFromYAML(scenePath)) {
+            std::cerr << "Failed to load scene for baking: " << scenePath << std::endl;
+            return 1;
+        }
+        std::cout << "Texture and model caches filled for " << scenePath << std::endl;
+        return 0;
+    }
+
+    // Offline: time texture sampling per texel format and layout
+    if (argc > 1 && std::string(argv[1]) == "--bench-textures") {
+        return bench_texture_sampling();
+    }
+
     std::cout << "Starting application..." << std::endl;
 
     SDLApp app(width, height, title); // Construction and initialization happens here
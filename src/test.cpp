@@ -146,4 +146,69 @@ int test_texture() {
     std::cout << "Successfully loaded " << successfulLoads << "/" << totalFiles << " DDS files" << std::endl;
 
     return 0;
-}
\ No newline at end of file
+}
+
+#include <chrono>
+#include <random>
+
+// In-memory texture for sampler benchmarks: a noisy checkerboard
+class BenchTexture : public Texture {
+public:
+    BenchTexture(int size, TexelFormat format, TexelLayout layout) {
+        std::mt19937 rng(42);
+        std::uniform_real_distribution<float> noise(0.0f, 0.25f);
+        std::vector<vec3f> pixels(static_cast<size_t>(size) * size);
+        for (int y = 0; y < size; ++y) {
+            for (int x = 0; x < size; ++x) {
+                float c = ((x / 16 + y / 16) & 1) ? 0.75f : 0.25f;
+                pixels[static_cast<size_t>(y) * size + x] = vec3f(c + noise(rng), c, c - noise(rng) * 0.5f);
+            }
+        }
+        mipLevels.resize(1);
+        encodeLevel(pixels, size, size, format, mipLevels[0], layout);
+    }
+
+    bool load(const std::string&) override { return false; }
+};
+
+// Walks a 1024x1024 "screen" whose UVs are rotated by several angles and scaled
+// so that one pixel step moves about one texel, and reports ns per sample for
+// each layout. Spans at 90 degrees are the worst case for row-major storage.
+int bench_texture_sampling() {
+    const int textureSize = 2048; // 16 MB as RGBA8, larger than typical L2
+    const int screenSize = 1024;
+    const float angles[] = { 0.0f, 30.0f, 45.0f, 90.0f };
+    const TexelLayout layouts[] = { TexelLayout::Linear, TexelLayout::Tiled4x4 };
+    const TexelFormat formats[] = { TexelFormat::RGBA8, TexelFormat::R8 };
+
+    for (TexelFormat format : formats) {
+        for (TexelLayout layout : layouts) {
+            BenchTexture texture(textureSize, format, layout);
+            std::cout << texelFormatName(format) << " " << texelLayoutName(layout) << ":";
+            for (float angle : angles) {
+                float radians = angle * 3.14159265f / 180.0f;
+                float step = 1.0f / textureSize;
+                vec2f du(std::cos(radians) * step, std::sin(radians) * step); // per screen x
+                vec2f dv(-std::sin(radians) * step, std::cos(radians) * step); // per screen y
+
+                float checksum = 0.0f;
+                double ns = 1e9;
+                for (int run = 0; run < 3; ++run) { // Best of three
+                    auto start = std::chrono::high_resolution_clock::now();
+                    for (int y = 0; y < screenSize; ++y) {
+                        for (int x = 0; x < screenSize; ++x) {
+                            float u = 0.1f + du.x * x + dv.x * y;
+                            float v = 0.1f + du.y * x + dv.y * y;
+                            checksum += texture.sample(u, v, du, dv).x;
+                        }
+                    }
+                    auto end = std::chrono::high_resolution_clock::now();
+                    ns = std::min(ns, std::chrono::duration<double, std::nano>(end - start).count() / (screenSize * screenSize));
+                }
+                std::cout << "  " << angle << "deg " << ns << " ns" << (checksum < 0.0f ? "!" : "");
+            }
+            std::cout << std::endl;
+        }
+    }
+    return 0;
+}